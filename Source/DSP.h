@@ -10,9 +10,69 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+
+// Build with PINGPONG_DETERMINISTIC=1 for bit-exact regression renders: no
+// FMA contraction in the DSP code and no idle skipping, which is decided per
+// host block. Everything with state runs per sample or per parameter grid
+// cell, and the vectorized code that touches the output only does exact
+// element-wise work, so it needs no scalar fallback. JUCE's own templates are
+// parsed before this header, so the build also passes -ffp-contract=off (or
+// /fp:precise); Tests/PingPongTests.jucer is set up that way.
+#ifndef PINGPONG_DETERMINISTIC
+ #define PINGPONG_DETERMINISTIC 0
+#endif
+
+#if PINGPONG_DETERMINISTIC
+ #if defined(__clang__)
+  #pragma clang fp contract(off)
+ #elif defined(_MSC_VER)
+  #pragma fp_contract(off)
+ #elif defined(__GNUC__)
+  #pragma GCC optimize("fp-contract=off")
+ #endif
+#endif
+
 inline void panningEqualPower(float panning, float& left, float& right)
 {
 	float x = 0.7853981633974483f * (panning + 1.f);
 	left = std::cos(x);
 	right = std::sin(x);
 }
+
+// four independent partial sums, which the compiler keeps in one vector
+// register; a single running sum can't be reordered without fast-math
+inline float sumOfSquares(const float* data, int numSamples) noexcept
+{
+	float lanes[4] = { 0.f, 0.f, 0.f, 0.f };
+	int i = 0;
+	
+	for (; i + 4 <= numSamples; i += 4) {
+		for (int lane = 0; lane < 4; ++lane) {
+			lanes[lane] += data[i + lane] * data[i + lane];
+		}
+	}
+	
+	for (; i < numSamples; ++i) {
+		lanes[0] += data[i] * data[i];
+	}
+	
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// FNV-1a over the bit patterns of the samples, used to compare renders
+inline std::uint64_t hashSamples(const float* data, int numSamples, std::uint64_t hash) noexcept
+{
+	for (int i = 0; i < numSamples; ++i) {
+		std::uint32_t bits;
+		std::memcpy(&bits, &data[i], sizeof(bits));
+		
+		for (int byte = 0; byte < 4; ++byte) {
+			hash ^= (bits >> (byte * 8)) & 0xff;
+			hash *= 1099511628211ull;
+		}
+	}
+	
+	return hash;
+}
@@ -9,6 +9,7 @@
 */
 
 #include "DelayLine.h"
+#include "DSP.h"
 
 //==============================================================================
 DelayLine::DelayLine()
@@ -20,16 +21,23 @@ DelayLine::~DelayLine()
 }
 
 //==============================================================================
-void DelayLine::setMaximumDelayInSamples(int maxLengthInSamples)
+void DelayLine::setMaximumDelayInSamples(int maxLengthInSamples, int newNumChannels)
 {
 	jassert(maxLengthInSamples > 0);
+	jassert(newNumChannels > 0);
 	
-	int paddedLength = maxLengthInSamples + 1;
+	// room for the extra taps of the Hermite interpolator
+	int paddedLength = maxLengthInSamples + 3;
 	
-	if (bufferLength < paddedLength) {
-		bufferLength = paddedLength;
+	bufferLength = std::max(bufferLength, paddedLength);
+	numChannels = newNumChannels;
+	
+	size_t size = size_t(bufferLength) * size_t(numChannels);
+	
+	if (allocatedSize < size) {
+		allocatedSize = size;
 		
-		buffer.reset(new float[size_t(bufferLength)]);
+		buffer.reset(new float[allocatedSize]);
 	}
 }
 
@@ -37,12 +45,12 @@ void DelayLine::reset() noexcept
 {
 	writeIndex = bufferLength - 1;
 	
-	for (size_t i = 0; i < size_t(bufferLength); ++i) {
+	for (size_t i = 0; i < allocatedSize; ++i) {
 		buffer[i] = 0.f;
 	}
 }
 
-void DelayLine::write(float input) noexcept
+void DelayLine::write(const float* frame) noexcept
 {
 	jassert(bufferLength > 0);
 	
@@ -52,7 +60,11 @@ void DelayLine::write(float input) noexcept
 		writeIndex = 0;
 	}
 	
-	buffer[size_t(writeIndex)] = input;
+	float* destination = buffer.get() + size_t(writeIndex) * size_t(numChannels);
+	
+	for (int channel = 0; channel < numChannels; ++channel) {
+		destination[channel] = frame[channel];
+	}
 }
 
 /* nearest neighbor rounding */
@@ -71,32 +83,114 @@ void DelayLine::write(float input) noexcept
 //}
 
 /* linear interpolation */
-float DelayLine::read(float delayInSamples) const noexcept
+//float DelayLine::read(float delayInSamples) const noexcept
+//{
+//	jassert(delayInSamples >= 0.f);
+//	jassert(delayInSamples <= bufferLength - 1.f);
+//	
+//	int integerDelay = int(delayInSamples);
+//	
+//	int readIndexA = writeIndex - integerDelay;
+//	
+//	if (readIndexA < 0) {
+//		readIndexA += bufferLength;
+//	}
+//	
+//	int readIndexB = readIndexA - 1;
+//	
+//	if (readIndexB < 0) {
+//		readIndexB += bufferLength;
+//	}
+//	
+//	float sampleA = buffer[size_t(readIndexA)];
+//	float sampleB = buffer[size_t(readIndexB)];
+//	
+//	float fraction = delayInSamples - float(integerDelay);
+//	
+//	// same formula as one-pole filter!
+//	return sampleA + fraction * (sampleB - sampleA);
+//}
+
+/* Hermite interpolation */
+float DelayLine::read(int channel, float delayInSamples) const noexcept
 {
-	jassert(delayInSamples >= 0.f);
-	jassert(delayInSamples <= bufferLength - 1.f);
+	jassert(channel >= 0 && channel < numChannels);
+	// 4-point, 3rd-order Hermite needs one newer and two older samples
+	jassert(delayInSamples >= 1.f);
+	jassert(delayInSamples <= bufferLength - 3.f);
 	
 	int integerDelay = int(delayInSamples);
 	
-	int readIndexA = writeIndex - integerDelay;
+	int readIndex0 = writeIndex - integerDelay;
 	
-	if (readIndexA < 0) {
-		readIndexA += bufferLength;
+	if (readIndex0 < 0) {
+		readIndex0 += bufferLength;
 	}
 	
-	int readIndexB = readIndexA - 1;
+	int readIndexM1 = readIndex0 + 1;
+	int readIndex1 = readIndex0 - 1;
+	int readIndex2 = readIndex0 - 2;
+	
+	if (readIndexM1 >= bufferLength) {
+		readIndexM1 -= bufferLength;
+	}
+	
+	if (readIndex1 < 0) {
+		readIndex1 += bufferLength;
+	}
 	
-	if (readIndexB < 0) {
-		readIndexB += bufferLength;
+	if (readIndex2 < 0) {
+		readIndex2 += bufferLength;
 	}
 	
-	float sampleA = buffer[size_t(readIndexA)];
-	float sampleB = buffer[size_t(readIndexB)];
+	const float* channelData = buffer.get() + channel;
+	size_t stride = size_t(numChannels);
+	
+	float sampleM1 = channelData[size_t(readIndexM1) * stride];
+	float sample0 = channelData[size_t(readIndex0) * stride];
+	float sample1 = channelData[size_t(readIndex1) * stride];
+	float sample2 = channelData[size_t(readIndex2) * stride];
 	
 	float fraction = delayInSamples - float(integerDelay);
 	
-	// same formula as one-pole filter!
-	return sampleA + fraction * (sampleB - sampleA);
+	float c1 = 0.5f * (sample1 - sampleM1);
+	float c2 = sampleM1 - 2.5f * sample0 + 2.f * sample1 - 0.5f * sample2;
+	float c3 = 0.5f * (sample2 - sampleM1) + 1.5f * (sample0 - sample1);
+	
+	return ((c3 * fraction + c2) * fraction + c1) * fraction + sample0;
 }
 
-/* Hermite interpolation */
+/* min/max of the most recently written samples of one channel */
+juce::Range<float> DelayLine::getRecentRange(int channel, int numSamples, int samplesAgo) const noexcept
+{
+	jassert(channel >= 0 && channel < numChannels);
+	jassert(samplesAgo >= 0 && samplesAgo < bufferLength);
+	
+	numSamples = std::min(numSamples, bufferLength - samplesAgo);
+	
+	if (numSamples <= 0) { return {}; }
+	
+	const float* channelData = buffer.get() + channel;
+	size_t stride = size_t(numChannels);
+	int index = writeIndex - samplesAgo;
+	
+	if (index < 0) {
+		index += bufferLength;
+	}
+	
+	float low = channelData[size_t(index) * stride];
+	float high = low;
+	
+	// walk back from the write position, wrapping around the start of the buffer
+	for (int i = 1; i < numSamples; ++i) {
+		if (--index < 0) {
+			index += bufferLength;
+		}
+		
+		float x = channelData[size_t(index) * stride];
+		low = std::min(low, x);
+		high = std::max(high, x);
+	}
+	
+	return { low, high };
+}
@@ -14,6 +14,9 @@
 
 //==============================================================================
 /**
+    Multichannel delay line. All channels share one contiguous, interleaved
+    ring buffer and one write position, so a frame is written with a single
+    call and the taps of every channel sit next to each other in memory.
 */
 class DelayLine
 {
@@ -22,16 +25,22 @@ public:
 	~DelayLine();
 	
 	//==============================================================================
-	void setMaximumDelayInSamples(int maxLengthInSamples);
+	void setMaximumDelayInSamples(int maxLengthInSamples, int numChannels = 1);
 	void reset() noexcept;
 	
-	void write(float input) noexcept;
-	float read(float delayInSamples) const noexcept;
+	// writes one sample for every channel and advances the write position
+	void write(const float* frame) noexcept;
+	float read(int channel, float delayInSamples) const noexcept;
+	// range of numSamples samples, ending samplesAgo before the latest write
+	juce::Range<float> getRecentRange(int channel, int numSamples, int samplesAgo = 0) const noexcept;
 	
 	int getBufferLength() const noexcept { return bufferLength; }
+	int getNumChannels() const noexcept { return numChannels; }
 	
 private:
 	std::unique_ptr<float[]> buffer;
+	size_t allocatedSize = 0;
 	int bufferLength = 0;
+	int numChannels = 0;
 	int writeIndex = 0;
 };
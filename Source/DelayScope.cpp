@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    DelayScope.cpp
+    Created: 19 Oct 2026 1:31:48pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#include "DelayScope.h"
+
+//==============================================================================
+DelayScope::DelayScope(WaveformSummary& summary_)
+	: summary(summary_)
+{
+	hub->subscribe(this, this);
+}
+
+DelayScope::~DelayScope()
+{
+	hub->unsubscribe(this);
+}
+
+//==============================================================================
+void DelayScope::paint(juce::Graphics& g)
+{
+	const auto bounds = getLocalBounds().toFloat();
+	
+	g.setColour(Colors::DelayScope::background);
+	g.fillRoundedRectangle(bounds, 4.f);
+	
+	// left channel on top, right channel below
+	juce::Rectangle<float> area = bounds.reduced(2.f);
+	juce::Rectangle<float> top = area.removeFromTop(area.getHeight() / 2.f);
+	
+	g.setColour(Colors::DelayScope::centerLine);
+	g.fillRect(top.getX(), top.getCentreY(), top.getWidth(), 1.f);
+	g.fillRect(area.getX(), area.getCentreY(), area.getWidth(), 1.f);
+	
+	g.setColour(Colors::DelayScope::waveform);
+	drawChannel(g, snapshot.minL, snapshot.maxL, top);
+	drawChannel(g, snapshot.minR, snapshot.maxR, area);
+}
+
+void DelayScope::refresh(double frameTime)
+{
+	if (frameTime - lastFrameTime < 1.0 / refreshRate) { return; }
+	lastFrameTime = frameTime;
+	
+	// nothing new while idle or bypassed, the last picture is still valid
+	juce::uint32 publishCount = summary.getPublishCount();
+	if (publishCount == lastPublishCount) { return; }
+	lastPublishCount = publishCount;
+	
+	summary.read(snapshot);
+	repaint();
+}
+
+void DelayScope::drawChannel(juce::Graphics& g,
+							 const std::array<float, WaveformSummary::numColumns>& minValues,
+							 const std::array<float, WaveformSummary::numColumns>& maxValues,
+							 juce::Rectangle<float> area)
+{
+	const float columnWidth = area.getWidth() / float(WaveformSummary::numColumns);
+	const float halfHeight = area.getHeight() / 2.f;
+	
+	// oldest column on the left, newest on the right
+	for (int i = 0; i < WaveformSummary::numColumns; ++i) {
+		size_t column = size_t((snapshot.head + i) % WaveformSummary::numColumns);
+		
+		float top = area.getCentreY() - juce::jlimit(-1.f, 1.f, maxValues[column]) * halfHeight;
+		float bottom = area.getCentreY() - juce::jlimit(-1.f, 1.f, minValues[column]) * halfHeight;
+		
+		g.fillRect(area.getX() + float(i) * columnWidth, top,
+				   std::max(columnWidth, 1.f), std::max(bottom - top, 1.f));
+	}
+}
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    DelayScope.h
+    Created: 19 Oct 2026 1:31:48pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LookAndFeel.h"
+#include "WaveformSummary.h"
+#include "RefreshHub.h"
+
+//==============================================================================
+/**
+*/
+class DelayScope  : public juce::Component, private RefreshHub::Client
+{
+public:
+	DelayScope(WaveformSummary& summary);
+	~DelayScope() override;
+	
+	//==============================================================================
+	void paint(juce::Graphics& g) override;
+
+private:
+	void refresh(double frameTime) override;
+	
+	void drawChannel(juce::Graphics& g, const std::array<float, WaveformSummary::numColumns>& minValues,
+					 const std::array<float, WaveformSummary::numColumns>& maxValues,
+					 juce::Rectangle<float> area);
+	
+	WaveformSummary& summary;
+	WaveformSummary::Snapshot snapshot;
+	
+	static constexpr int refreshRate = 30;
+	double lastFrameTime = 0.0;
+	juce::uint32 lastPublishCount = 0;
+	
+	juce::SharedResourcePointer<RefreshHub> hub;
+	
+	//==============================================================================
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayScope)
+};
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    Ducker.h
+    Created: 19 Oct 2026 9:14:52pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Envelope follower on a key signal, the dry input or the sidechain, that
+    turns down the wet signal while the key is above the threshold, or in
+    gate mode turns down the feedback while it's below. The gain changes
+    over the 6 dB above the threshold, so it follows the envelope smoothly.
+*/
+class Ducker
+{
+public:
+	void prepare(double newSampleRate) noexcept
+	{
+		sampleRate = float(newSampleRate);
+		attackTime = -1.f;
+		releaseTime = -1.f;
+		reset();
+	}
+	
+	void reset() noexcept
+	{
+		envelope = 0.f;
+	}
+	
+	void setParameters(float thresholdDecibels, float amountPercent,
+					   float attackMilliseconds, float releaseMilliseconds) noexcept
+	{
+		threshold = juce::Decibels::decibelsToGain(thresholdDecibels);
+		inverseThreshold = 1.f / threshold;
+		amount = amountPercent * 0.01f;
+		
+		// the coefficients only need an exp when the times move
+		if (!juce::exactlyEqual(attackMilliseconds, attackTime)) {
+			attackTime = attackMilliseconds;
+			attackCoeff = 1.f - std::exp(-1.f / (0.001f * attackTime * sampleRate));
+		}
+		
+		if (!juce::exactlyEqual(releaseMilliseconds, releaseTime)) {
+			releaseTime = releaseMilliseconds;
+			releaseCoeff = 1.f - std::exp(-1.f / (0.001f * releaseTime * sampleRate));
+		}
+	}
+	
+	// returns the gain for the wet signal
+	float process(float key) noexcept
+	{
+		return 1.f - amount * follow(key);
+	}
+	
+	// returns the gain for the feedback, which closes while the key is quiet
+	float processGate(float key) noexcept
+	{
+		return 1.f - amount * (1.f - follow(key));
+	}
+	
+private:
+	// how far the envelope is above the threshold, 0..1
+	float follow(float key) noexcept
+	{
+		float level = std::abs(key);
+		float coeff = level > envelope ? attackCoeff : releaseCoeff;
+		envelope += (level - envelope) * coeff;
+		
+		return juce::jlimit(0.f, 1.f, (envelope - threshold) * inverseThreshold);
+	}
+	
+
+	float sampleRate = 44100.f;
+	float threshold = 1.f;
+	float inverseThreshold = 1.f;
+	float amount = 0.f;
+	float attackTime = -1.f;
+	float releaseTime = -1.f;
+	float attackCoeff = 1.f;
+	float releaseCoeff = 1.f;
+	float envelope = 0.f;
+};
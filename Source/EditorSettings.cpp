@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    EditorSettings.cpp
+    Created: 19 Oct 2026 4:48:51pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#include "EditorSettings.h"
+
+//==============================================================================
+EditorSettings::EditorSettings()
+{
+	pool.addJob([this]
+	{
+		juce::PropertiesFile file { getOptions() };
+		const juce::StringPairArray& stored = file.getAllProperties();
+		
+		{
+			const juce::ScopedLock sl(lock);
+			
+			// anything set while the file was loading wins
+			for (const juce::String& key : stored.getAllKeys()) {
+				if (!values.contains(key)) {
+					values.set(key, stored[key]);
+				}
+			}
+		}
+		
+		loaded.store(true);
+		sendChangeMessage();
+	});
+}
+
+EditorSettings::~EditorSettings()
+{
+	stopTimer();
+	pool.removeAllJobs(false, 2000);
+	
+	// flush whatever hasn't been written yet, including a write job that was
+	// still queued and has just been removed without running
+	if (needsWriting || pendingWrites.load() > 0) {
+		write(values);
+	}
+}
+
+//==============================================================================
+juce::var EditorSettings::getValue(const juce::Identifier& key, const juce::var& defaultValue) const
+{
+	const juce::ScopedLock sl(lock);
+	return values.getWithDefault(key, defaultValue);
+}
+
+void EditorSettings::setValue(const juce::Identifier& key, const juce::var& value)
+{
+	JUCE_ASSERT_MESSAGE_THREAD
+	
+	{
+		const juce::ScopedLock sl(lock);
+		
+		if (!values.set(key, value)) { return; }
+	}
+	
+	// restart the countdown, a drag only gets written once it's finished
+	needsWriting = true;
+	startTimer(writeDelayMs);
+}
+
+//==============================================================================
+void EditorSettings::timerCallback()
+{
+	stopTimer();
+	
+	juce::NamedValueSet valuesToWrite;
+	{
+		const juce::ScopedLock sl(lock);
+		valuesToWrite = values;
+	}
+	
+	needsWriting = false;
+	++pendingWrites;
+	
+	pool.addJob([this, valuesToWrite]
+	{
+		write(valuesToWrite);
+		--pendingWrites;
+	});
+}
+
+juce::PropertiesFile::Options EditorSettings::getOptions()
+{
+	juce::PropertiesFile::Options options;
+	options.applicationName = ProjectInfo::projectName;
+	options.folderName = ProjectInfo::companyName;
+	options.commonToAllUsers = true;
+	options.filenameSuffix = "settings";
+	options.osxLibrarySubFolder = "Application Support";
+	return options;
+}
+
+void EditorSettings::write(const juce::NamedValueSet& valuesToWrite)
+{
+	// the file reads what's on disk first, so keys we don't know about survive
+	juce::PropertiesFile file { getOptions() };
+	
+	for (const juce::NamedValueSet::NamedValue& value : valuesToWrite) {
+		file.setValue(value.name.toString(), value.value);
+	}
+	
+	file.saveIfNeeded();
+}
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    EditorSettings.h
+    Created: 19 Oct 2026 4:48:51pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Process-wide cache of the editor settings file. The file is read on a
+    background thread when the first instance is created, and changes are
+    written back on that thread once they've settled. Hold it through a
+    juce::SharedResourcePointer; a change message is sent once loading is done.
+*/
+class EditorSettings  : public juce::ChangeBroadcaster, private juce::Timer
+{
+public:
+	EditorSettings();
+	~EditorSettings() override;
+	
+	//==============================================================================
+	bool isLoaded() const noexcept { return loaded.load(); }
+	
+	juce::var getValue(const juce::Identifier& key, const juce::var& defaultValue) const;
+	void setValue(const juce::Identifier& key, const juce::var& value);
+
+private:
+	void timerCallback() override;
+	
+	static juce::PropertiesFile::Options getOptions();
+	static void write(const juce::NamedValueSet& valuesToWrite);
+	
+	juce::NamedValueSet values;
+	juce::CriticalSection lock;
+	std::atomic<bool> loaded { false };
+	bool needsWriting = false;
+	
+	// write jobs queued on the pool that haven't finished yet
+	std::atomic<int> pendingWrites { 0 };
+	
+	// settle time before a change is written to disk
+	static constexpr int writeDelayMs = 1000;
+	
+	juce::ThreadPool pool { 1 };
+	
+	//==============================================================================
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditorSettings)
+};
@@ -17,27 +17,55 @@ LevelMeter::LevelMeter(Measurement& measurementL_,
 	  dbLevelL(clampdB), dbLevelR(clampdB)
 {
 	//setOpaque(true);
-	startTimerHz(refreshRate);
-	
-	decay = 1.f - std::exp(-1.f / (float(refreshRate) * 0.2f));
+	hub->subscribe(this, this);
 }
 
 LevelMeter::~LevelMeter()
 {
+	hub->unsubscribe(this);
 }
 
 //==============================================================================
 void LevelMeter::paint(juce::Graphics& g)
 {
-	const auto bounds = getLocalBounds();
-	
 	//g.fillAll(Colors::LevelMeter::background);
 	
-	g.setFont(Fonts::getFont(10.f));
-	
 	drawLevel(g, dbLevelL, 0, 7);
 	drawLevel(g, dbLevelR, 9, 7);
 	
+	float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	if (scaleImage.isNull() || !juce::approximatelyEqual(scale, scaleImageScale)) {
+		renderScale(scale);
+	}
+	
+	g.drawImage(scaleImage, getLocalBounds().toFloat());
+}
+
+void LevelMeter::resized()
+{
+	maxPos = 4.f;
+	minPos = float(getHeight()) - 4.f;
+	
+	lastYL = getHeight();
+	lastYR = getHeight();
+	
+	// size changed, draw the scale again on the next paint
+	scaleImage = juce::Image();
+}
+
+void LevelMeter::renderScale(float scale)
+{
+	const auto bounds = getLocalBounds();
+	
+	int width = std::max(1, juce::roundToInt(float(bounds.getWidth()) * scale));
+	int height = std::max(1, juce::roundToInt(float(bounds.getHeight()) * scale));
+	scaleImage = juce::Image(juce::Image::ARGB, width, height, true);
+	scaleImageScale = scale;
+	
+	juce::Graphics g { scaleImage };
+	g.addTransform(juce::AffineTransform::scale(scale));
+	g.setFont(Fonts::getFont(10.f));
+	
 	for (float db = maxdB; db >= mindB; db -= stepdB) {
 		int y = positionForLevel(db);
 		
@@ -50,18 +78,41 @@ void LevelMeter::paint(juce::Graphics& g)
 	}
 }
 
-void LevelMeter::resized()
+void LevelMeter::mouseDown([[maybe_unused]] const juce::MouseEvent& event)
 {
-	maxPos = 4.f;
-	minPos = float(getHeight()) - 4.f;
+	if (onClick != nullptr) {
+		onClick();
+	}
 }
 
-void LevelMeter::timerCallback()
+void LevelMeter::refresh(double frameTime)
 {
+	double elapsed = frameTime - lastFrameTime;
+	
+	// nothing to animate, only poll for new audio until something shows up
+	bool silent = dbLevelL <= clampdB && dbLevelR <= clampdB;
+	if (silent && elapsed < 1.0 / idleRefreshRate) { return; }
+	
+	lastFrameTime = frameTime;
+	
+	// frames don't arrive at a fixed rate, so base the fall-off on real time
+	decay = 1.f - std::exp(-float(std::min(elapsed, 0.1)) / 0.2f);
+	
 	updateLevel(measurementL.readAndReset(), levelL, dbLevelL);
 	updateLevel(measurementR.readAndReset(), levelR, dbLevelR);
 	
-	repaint();
+	repaintBar(0, 7, dbLevelL, lastYL);
+	repaintBar(9, 7, dbLevelR, lastYR);
+}
+
+void LevelMeter::repaintBar(int x, int width, float leveldB, int& lastY)
+{
+	int y = juce::jlimit(0, getHeight(), positionForLevel(leveldB));
+	
+	if (y != lastY) {
+		repaint(x, std::min(y, lastY), width, std::abs(y - lastY));
+		lastY = y;
+	}
 }
 
 void LevelMeter::drawLevel(juce::Graphics &g, float level, int x, int width)
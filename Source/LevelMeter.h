@@ -13,11 +13,12 @@
 #include <JuceHeader.h>
 #include "LookAndFeel.h"
 #include "Measurement.h"
+#include "RefreshHub.h"
 
 //==============================================================================
 /**
 */
-class LevelMeter  : public juce::Component, private juce::Timer
+class LevelMeter  : public juce::Component, private RefreshHub::Client
 {
 public:
 	LevelMeter(Measurement& measurementL,
@@ -27,9 +28,12 @@ public:
 	//==============================================================================
 	void paint(juce::Graphics& g) override;
 	void resized() override;
+	void mouseDown(const juce::MouseEvent& event) override;
+	
+	std::function<void()> onClick;
 
 private:
-	void timerCallback() override;
+	void refresh(double frameTime) override;
 	
 	int positionForLevel(float dbLevel) const noexcept
 	{
@@ -38,6 +42,8 @@ private:
 	
 	void drawLevel(juce::Graphics& g, float level, int x, int width);
 	void updateLevel(float newLevel, float& smoothedLevel, float& leveldB) const;
+	void repaintBar(int x, int width, float leveldB, int& lastY);
+	void renderScale(float scale);
 	
 	Measurement& measurementL;
 	Measurement& measurementR;
@@ -47,7 +53,7 @@ private:
 	static constexpr float stepdB = 6.f;
 	static constexpr float clampdB = -120.f;
 	static constexpr float clampLevel = 0.000001f;
-	static constexpr int refreshRate = 60;
+	static constexpr int idleRefreshRate = 10;
 	
 	float maxPos = 0.f;
 	float minPos = 0.f;
@@ -56,6 +62,17 @@ private:
 	float decay = 0.f;
 	float levelL = clampLevel;
 	float levelR = clampLevel;
+	double lastFrameTime = 0.0;
+	
+	// bar tops from the last repaint, only the difference gets repainted
+	int lastYL = 0;
+	int lastYR = 0;
+	
+	// tick lines and dB labels, rendered once per size and scale
+	juce::Image scaleImage;
+	float scaleImageScale = 0.f;
+	
+	juce::SharedResourcePointer<RefreshHub> hub;
 	
 	//==============================================================================
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
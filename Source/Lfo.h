@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    Lfo.h
+    Created: 19 Oct 2026 8:02:15pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Stereo LFO for delay modulation, rendered a block at a time into tables.
+    The sine is a recursive oscillator restarted from the phase accumulator
+    every block, so there are only a handful of trig calls per block and no
+    long-term drift. The processor always renders whole parameter grid cells,
+    so the output doesn't depend on the host block size. The right channel
+    runs phaseOffset cycles ahead.
+*/
+class Lfo
+{
+public:
+	enum Shape { sine = 0, triangle, randomWalk };
+	
+	//==============================================================================
+	void prepare(double sampleRate) noexcept
+	{
+		inverseSampleRate = 1.0 / sampleRate;
+		reset();
+	}
+	
+	void reset() noexcept
+	{
+		phase = 0.0;
+		
+		// same seed on both sides so an offset of zero gives identical walks
+		walkL = Walk();
+		walkR = Walk();
+	}
+	
+	void setRate(float newRate) noexcept { rate = newRate; }
+	void setShape(int newShape) noexcept { shape = newShape; }
+	void setPhaseOffset(float cycles) noexcept { phaseOffset = cycles; }
+	
+	// fills both tables with values in -1..1
+	void process(float* left, float* right, int numSamples) noexcept
+	{
+		double increment = rate * inverseSampleRate;
+		
+		if (shape == sine) {
+			// rotate (c, s) by the phase increment every sample
+			double angle = juce::MathConstants<double>::twoPi * phase;
+			double step = juce::MathConstants<double>::twoPi * increment;
+			double offset = juce::MathConstants<double>::twoPi * phaseOffset;
+			
+			float s = float(std::sin(angle));
+			float c = float(std::cos(angle));
+			float sinStep = float(std::sin(step));
+			float cosStep = float(std::cos(step));
+			float sinOffset = float(std::sin(offset));
+			float cosOffset = float(std::cos(offset));
+			
+			for (int i = 0; i < numSamples; ++i) {
+				left[i] = s;
+				right[i] = s * cosOffset + c * sinOffset;
+				
+				float next = s * cosStep + c * sinStep;
+				c = c * cosStep - s * sinStep;
+				s = next;
+			}
+		} else if (shape == triangle) {
+			for (int i = 0; i < numSamples; ++i) {
+				float p = wrap(float(phase + i * increment));
+				left[i] = 4.f * std::abs(p - 0.5f) - 1.f;
+				right[i] = 4.f * std::abs(wrap(p + phaseOffset) - 0.5f) - 1.f;
+			}
+		} else {
+			for (int i = 0; i < numSamples; ++i) {
+				float p = wrap(float(phase + i * increment));
+				left[i] = walkL.next(p);
+				right[i] = walkR.next(wrap(p + phaseOffset));
+			}
+		}
+		
+		phase += numSamples * increment;
+		phase -= std::floor(phase);
+	}
+	
+private:
+	static float wrap(float p) noexcept { return p - std::floor(p); }
+	
+	// a new random target every cycle, eased towards with a smoothstep
+	struct Walk
+	{
+		juce::Random random { 0x5eed };
+		float start = 0.f;
+		float end = 0.f;
+		float lastPhase = 0.f;
+		
+		float next(float p) noexcept
+		{
+			if (p < lastPhase) {
+				start = end;
+				end = juce::jlimit(-1.f, 1.f, end + random.nextFloat() - 0.5f);
+			}
+			lastPhase = p;
+			
+			return start + (end - start) * p * p * (3.f - 2.f * p);
+		}
+	};
+	
+	double inverseSampleRate = 1.0 / 44100.0;
+	double phase = 0.0;
+	float rate = 1.f;
+	float phaseOffset = 0.f;
+	int shape = sine;
+	
+	Walk walkL, walkR;
+};
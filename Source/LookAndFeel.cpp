@@ -53,41 +53,20 @@ void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics &g,
 {
 	juce::Rectangle<float> bounds = juce::Rectangle<int>(x, y, width, width).toFloat();
 	juce::Rectangle<float> knobRect = bounds.reduced(10.f, 10.f);
-	
-	// draw drop shadow along path (expand bounds to get rid of weird lines)
-	juce::Path path;
-	path.addEllipse(knobRect.expanded(1.f, 3.f));
-	dropShadow.drawForPath(g, path);
-	
-	// draw knob outline
-	g.setColour(Colors::Knob::outline);
-	g.fillEllipse(knobRect);
-	
-	// fill knob gradient
 	juce::Rectangle<float> innerRect = knobRect.reduced(2.0f, 2.0f);
-	juce::ColourGradient gradient { Colors::Knob::gradientTop, 0.0f,
-									innerRect.getY(),
-									Colors::Knob::gradientBottom, 0.0f,
-									innerRect.getBottom(), false };
-	g.setGradientFill(gradient);
-	g.fillEllipse(innerRect);
 	
-	// draw track around knob
+	// blit the cached shadow, knob body and background track
+	float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	g.drawImage(getStaticLayers(width, scale, rotaryStartAngle, rotaryEndAngle), bounds);
+	
 	juce::Point<float> center = bounds.getCentre();
 	float radius = bounds.getWidth() / 2.f;
 	float lineWidth = 3.f;
 	float arcRadius = radius - lineWidth / 2.f;
 	
-	juce::Path backgroundArc;
-	backgroundArc.addCentredArc(center.x, center.y,
-								arcRadius, arcRadius, 0.f,
-								rotaryStartAngle, rotaryEndAngle, true);
-	
 	juce::PathStrokeType strokeType { lineWidth,
 									  juce::PathStrokeType::curved,
 									  juce::PathStrokeType::rounded };
-	g.setColour(Colors::Knob::trackBackground);
-	g.strokePath(backgroundArc, strokeType);
 	
 	// draw the knob dial
 	float dialRadius = innerRect.getHeight() / 2.f - lineWidth;
@@ -121,6 +100,72 @@ void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics &g,
 	}
 }
 
+juce::Image RotaryKnobLookAndFeel::getStaticLayers(int size, float scale,
+												   float rotaryStartAngle, float rotaryEndAngle)
+{
+	auto key = std::make_tuple(size, juce::roundToInt(scale * 100.f), rotaryStartAngle, rotaryEndAngle);
+	
+	if (auto it = layerCache.find(key); it != layerCache.end()) {
+		return it->second;
+	}
+	
+	// only a handful of sizes are ever live at once
+	if (layerCache.size() > 16) {
+		layerCache.clear();
+	}
+	
+	// render at physical resolution so the blit is 1:1 on the screen
+	int pixels = std::max(1, juce::roundToInt(float(size) * scale));
+	juce::Image image { juce::Image::ARGB, pixels, pixels, true };
+	
+	// draw into the image, the context has to be gone before the image is used
+	{
+		juce::Graphics g { image };
+		g.addTransform(juce::AffineTransform::scale(float(pixels) / float(size)));
+		
+		juce::Rectangle<float> bounds = juce::Rectangle<int>(0, 0, size, size).toFloat();
+		juce::Rectangle<float> knobRect = bounds.reduced(10.f, 10.f);
+		
+		// draw drop shadow along path (expand bounds to get rid of weird lines)
+		juce::Path path;
+		path.addEllipse(knobRect.expanded(1.f, 3.f));
+		dropShadow.drawForPath(g, path);
+		
+		// draw knob outline
+		g.setColour(Colors::Knob::outline);
+		g.fillEllipse(knobRect);
+		
+		// fill knob gradient
+		juce::Rectangle<float> innerRect = knobRect.reduced(2.0f, 2.0f);
+		juce::ColourGradient gradient { Colors::Knob::gradientTop, 0.0f,
+										innerRect.getY(),
+										Colors::Knob::gradientBottom, 0.0f,
+										innerRect.getBottom(), false };
+		g.setGradientFill(gradient);
+		g.fillEllipse(innerRect);
+		
+		// draw track around knob
+		juce::Point<float> center = bounds.getCentre();
+		float radius = bounds.getWidth() / 2.f;
+		float lineWidth = 3.f;
+		float arcRadius = radius - lineWidth / 2.f;
+		
+		juce::Path backgroundArc;
+		backgroundArc.addCentredArc(center.x, center.y,
+									arcRadius, arcRadius, 0.f,
+									rotaryStartAngle, rotaryEndAngle, true);
+		
+		juce::PathStrokeType strokeType { lineWidth,
+										  juce::PathStrokeType::curved,
+										  juce::PathStrokeType::rounded };
+		g.setColour(Colors::Knob::trackBackground);
+		g.strokePath(backgroundArc, strokeType);
+	}
+	
+	layerCache[key] = image;
+	return image;
+}
+
 juce::Font RotaryKnobLookAndFeel::getLabelFont([[maybe_unused]] juce::Label &label)
 {
 	// get custom font and set to all labels
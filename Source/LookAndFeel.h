@@ -104,6 +104,13 @@ namespace Colors
 		const juce::Colour tooLoud { 226, 74, 81 };
 		const juce::Colour levelOK { 65, 206, 88 };
 	}
+	
+	namespace DelayScope
+	{
+		const juce::Colour background { 30, 30, 30 };
+		const juce::Colour centerLine { 57, 57, 57 };
+		const juce::Colour waveform { 200, 100, 0 };
+	}
 }
 
 //==============================================================================
@@ -143,9 +150,15 @@ public:
 								  juce::TextEditor& textEditor) override;
 
 private:
+	juce::Image getStaticLayers(int size, float scale,
+								float rotaryStartAngle, float rotaryEndAngle);
+	
 	juce::DropShadow dropShadow { Colors::Knob::dropShadow, 6,
 								  juce::Point<int> { 0, 3 } };
 	
+	// shadow, body and background track, rendered once per knob size and scale
+	std::map<std::tuple<int, int, float, float>, juce::Image> layerCache;
+	
 	//==============================================================================
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RotaryKnobLookAndFeel)
 };
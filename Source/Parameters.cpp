@@ -45,6 +45,16 @@ static juce::String stringFromPercent(float value, int)
 	return juce::String(int(value)) + " %";
 }
 
+static juce::String stringFromRate(float value, int)
+{
+	return juce::String(value, 2) + " Hz";
+}
+
+static juce::String stringFromDegrees(float value, int)
+{
+	return juce::String(int(value)) + juce::String::fromUTF8(" \xc2\xb0");
+}
+
 static juce::String stringFromHz(float value, int)
 {
 	if (value < 1000.f) {
@@ -95,10 +105,44 @@ Parameters::Parameters(juce::AudioProcessorValueTreeState& apvts)
 	castParameter(apvts, tempoSyncParamID, tempoSyncParam);
 	castParameter(apvts, delayNoteParamID, delayNoteParam);
 	castParameter(apvts, bypassParamID, bypassParam);
+	castParameter(apvts, morphParamID, morphParam);
+	
+	// plain values behind the parameters, read lock-free on the audio thread
+	gainValue = apvts.getRawParameterValue(gainParamID.getParamID());
+	delayTimeValue = apvts.getRawParameterValue(delayTimeParamID.getParamID());
+	mixValue = apvts.getRawParameterValue(mixParamID.getParamID());
+	feedbackValue = apvts.getRawParameterValue(feedbackParamID.getParamID());
+	stereoValue = apvts.getRawParameterValue(stereoParamID.getParamID());
+	lowCutValue = apvts.getRawParameterValue(lowCutParamID.getParamID());
+	highCutValue = apvts.getRawParameterValue(highCutParamID.getParamID());
+	tempoSyncValue = apvts.getRawParameterValue(tempoSyncParamID.getParamID());
+	delayNoteValue = apvts.getRawParameterValue(delayNoteParamID.getParamID());
+	bypassValue = apvts.getRawParameterValue(bypassParamID.getParamID());
+	bypassFeedValue = apvts.getRawParameterValue(bypassFeedParamID.getParamID());
+	morphValue = apvts.getRawParameterValue(morphParamID.getParamID());
+	saturationValue = apvts.getRawParameterValue(saturationParamID.getParamID());
+	modRateValue = apvts.getRawParameterValue(modRateParamID.getParamID());
+	modDepthValue = apvts.getRawParameterValue(modDepthParamID.getParamID());
+	modShapeValue = apvts.getRawParameterValue(modShapeParamID.getParamID());
+	modPhaseValue = apvts.getRawParameterValue(modPhaseParamID.getParamID());
+	duckThresholdValue = apvts.getRawParameterValue(duckThresholdParamID.getParamID());
+	duckAmountValue = apvts.getRawParameterValue(duckAmountParamID.getParamID());
+	duckAttackValue = apvts.getRawParameterValue(duckAttackParamID.getParamID());
+	duckReleaseValue = apvts.getRawParameterValue(duckReleaseParamID.getParamID());
+	sidechainValue = apvts.getRawParameterValue(sidechainParamID.getParamID());
+	crossfeedValue = apvts.getRawParameterValue(crossfeedParamID.getParamID());
+	crossfeedModeValue = apvts.getRawParameterValue(crossfeedModeParamID.getParamID());
 }
 
 Parameters::~Parameters()
 {
+	delete pendingSnapshots.exchange(nullptr);
+	delete activeSnapshots;
+	
+	MorphSnapshots* retired;
+	while (retiredSnapshots.pop(retired)) {
+		delete retired;
+	}
 }
 
 //==============================================================================
@@ -211,6 +255,121 @@ juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createParameterL
 		false
 	));
 	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		morphParamID,
+		"Morph",
+		juce::NormalisableRange<float> { 0.f, 100.f, 0.1f },
+		0.f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromPercent)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterChoice>(
+		saturationParamID,
+		"Saturation",
+		juce::StringArray { "Off", "Soft Clip", "Tape" },
+		0
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		modRateParamID,
+		"Mod Rate",
+		juce::NormalisableRange<float> { 0.05f, 10.f, 0.01f, 0.4f },
+		0.5f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromRate)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		modDepthParamID,
+		"Mod Depth",
+		juce::NormalisableRange<float> { 0.f, maxModDepth, 0.01f, 0.5f },
+		0.f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromMilliseconds)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterChoice>(
+		modShapeParamID,
+		"Mod Shape",
+		juce::StringArray { "Sine", "Triangle", "Random" },
+		0
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		modPhaseParamID,
+		"Mod Phase",
+		juce::NormalisableRange<float> { 0.f, 180.f, 1.f },
+		90.f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromDegrees)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		duckThresholdParamID,
+		"Duck Threshold",
+		juce::NormalisableRange<float> { -60.f, 0.f, 0.1f },
+		-30.f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromDecibels)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		duckAmountParamID,
+		"Duck Amount",
+		juce::NormalisableRange<float> { 0.f, 100.f, 1.f },
+		0.f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromPercent)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		duckAttackParamID,
+		"Duck Attack",
+		juce::NormalisableRange<float> { 0.1f, 100.f, 0.01f, 0.4f },
+		10.f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromMilliseconds)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		duckReleaseParamID,
+		"Duck Release",
+		juce::NormalisableRange<float> { 10.f, 2000.f, 1.f, 0.4f },
+		250.f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromMilliseconds)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterChoice>(
+		sidechainParamID,
+		"Sidechain",
+		juce::StringArray { "Off", "Duck", "Gate" },
+		0
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterFloat>(
+		crossfeedParamID,
+		"Cross-feed",
+		juce::NormalisableRange<float> { 0.f, 100.f, 1.f },
+		0.f,
+		juce::AudioParameterFloatAttributes()
+			.withStringFromValueFunction(stringFromPercent)
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterChoice>(
+		crossfeedModeParamID,
+		"Cross-feed Mode",
+		juce::StringArray { "Spread", "Rotate" },
+		0
+	));
+	
+	layout.add(std::make_unique<juce::AudioParameterBool>(
+		bypassFeedParamID,
+		"Bypass Feeds Delay",
+		false
+	));
+	
 	return layout;
 }
 
@@ -253,24 +412,123 @@ void Parameters::reset() noexcept
 	
 	highCut = 20000.f;
 	highCutSmoother.setCurrentAndTargetValue(highCutParam->get());
+	
+	// the next update retargets everything
+	forceUpdate = true;
 }
 
 void Parameters::update() noexcept
 {
-	/** update target values for linear smoothing parameters **/
-	gainSmoother.setTargetValue(juce::Decibels::decibelsToGain(gainParam->get()));
-	mixSmoother.setTargetValue(mixParam->get() * 0.01f);
-	feedbackSmoother.setTargetValue(feedbackParam->get() * 0.01f);
-	stereoSmoother.setTargetValue(stereoParam->get() * 0.01f);
-	lowCutSmoother.setTargetValue(lowCutParam->get());
-	highCutSmoother.setTargetValue(highCutParam->get());
-	
-	delayNote = delayNoteParam->getIndex();
-	tempoSync = tempoSyncParam->get();
-	bypassed = bypassParam->get();
+	// pick up newly published snapshots, the old ones go back for deleting
+	if (MorphSnapshots* fresh = pendingSnapshots.exchange(nullptr)) {
+		if (activeSnapshots != nullptr) {
+			retiredSnapshots.push(activeSnapshots);
+		}
+		activeSnapshots = fresh;
+	}
+	
+	ParameterSnapshot values;
+	
+	if (activeSnapshots != nullptr && activeSnapshots->isActive()) {
+		float t = morphValue->load(std::memory_order_relaxed) * 0.01f;
+		ParameterSnapshot knobs = readCurrentValues();
+		
+		/** morph between snapshot A and B **/
+		const ParameterSnapshot& a = activeSnapshots->a;
+		const ParameterSnapshot& b = activeSnapshots->b;
+		
+		// where the knobs were when a snapshot was last stored is the zero
+		// point, turning one afterwards offsets the morphed value
+		const ParameterSnapshot& morphBase = activeSnapshots->base;
+		
+		auto limit = [](juce::AudioParameterFloat* parameter, float value)
+		{
+			return juce::jlimit(parameter->range.start, parameter->range.end, value);
+		};
+		
+		values.gain = limit(gainParam, a.gain + (b.gain - a.gain) * t + knobs.gain - morphBase.gain);
+		values.delayTime = limit(delayTimeParam, a.delayTime + (b.delayTime - a.delayTime) * t
+											  + knobs.delayTime - morphBase.delayTime);
+		values.mix = limit(mixParam, a.mix + (b.mix - a.mix) * t + knobs.mix - morphBase.mix);
+		values.feedback = limit(feedbackParam, a.feedback + (b.feedback - a.feedback) * t
+											 + knobs.feedback - morphBase.feedback);
+		values.stereo = limit(stereoParam, a.stereo + (b.stereo - a.stereo) * t + knobs.stereo - morphBase.stereo);
+		
+		// cutoffs move on a log scale so the sweep sounds even, the knobs
+		// offset them by a ratio for the same reason
+		values.lowCut = limit(lowCutParam, a.lowCut * std::pow(b.lowCut / a.lowCut, t)
+										   * knobs.lowCut / morphBase.lowCut);
+		values.highCut = limit(highCutParam, a.highCut * std::pow(b.highCut / a.highCut, t)
+											 * knobs.highCut / morphBase.highCut);
+	} else {
+		values = readCurrentValues();
+	}
+	
+	int newDelayNote = int(delayNoteValue->load(std::memory_order_relaxed));
+	bool newTempoSync = tempoSyncValue->load(std::memory_order_relaxed) >= 0.5f;
+	bypassed = bypassValue->load(std::memory_order_relaxed) >= 0.5f;
+	bypassFeedsDelay = bypassFeedValue->load(std::memory_order_relaxed) >= 0.5f;
+	saturation = int(saturationValue->load(std::memory_order_relaxed));
+	modRate = modRateValue->load(std::memory_order_relaxed);
+	modDepth = modDepthValue->load(std::memory_order_relaxed);
+	modShape = int(modShapeValue->load(std::memory_order_relaxed));
+	modPhase = modPhaseValue->load(std::memory_order_relaxed) / 360.f;
+	duckThreshold = duckThresholdValue->load(std::memory_order_relaxed);
+	duckAmount = duckAmountValue->load(std::memory_order_relaxed);
+	duckAttack = duckAttackValue->load(std::memory_order_relaxed);
+	duckRelease = duckReleaseValue->load(std::memory_order_relaxed);
+	sidechainMode = int(sidechainValue->load(std::memory_order_relaxed));
+	crossfeed = crossfeedValue->load(std::memory_order_relaxed) * 0.01f;
+	crossfeedMode = int(crossfeedModeValue->load(std::memory_order_relaxed));
+	
+	/** only convert and retarget the values that actually moved **/
+	bool changed = forceUpdate || newDelayNote != delayNote || newTempoSync != tempoSync;
+	
+	if (forceUpdate || !juce::exactlyEqual(values.gain, lastValues.gain)) {
+		gainSmoother.setTargetValue(juce::Decibels::decibelsToGain(values.gain));
+		changed = true;
+	}
+	
+	if (forceUpdate || !juce::exactlyEqual(values.mix, lastValues.mix)) {
+		mixSmoother.setTargetValue(values.mix * 0.01f);
+		changed = true;
+	}
+	
+	if (forceUpdate || !juce::exactlyEqual(values.feedback, lastValues.feedback)) {
+		feedbackSmoother.setTargetValue(values.feedback * 0.01f);
+		changed = true;
+	}
+	
+	if (forceUpdate || !juce::exactlyEqual(values.stereo, lastValues.stereo)) {
+		stereoSmoother.setTargetValue(values.stereo * 0.01f);
+		changed = true;
+	}
+	
+	if (forceUpdate || !juce::exactlyEqual(values.lowCut, lastValues.lowCut)) {
+		lowCutSmoother.setTargetValue(values.lowCut);
+		changed = true;
+	}
+	
+	if (forceUpdate || !juce::exactlyEqual(values.highCut, lastValues.highCut)) {
+		highCutSmoother.setTargetValue(values.highCut);
+		changed = true;
+	}
+	
+	if (forceUpdate || !juce::exactlyEqual(values.delayTime, lastValues.delayTime)) {
+		targetDelayTime = values.delayTime;
+		changed = true;
+	}
+	
+	delayNote = newDelayNote;
+	tempoSync = newTempoSync;
+	lastValues = values;
+	forceUpdate = false;
+	
+	if (changed) {
+		++generation;
+	}
 	
 	// set delayTime only when it hasn't been set yet
-	targetDelayTime = delayTimeParam->get();
 	if (delayTime == 0.f) {
 		delayTime = targetDelayTime;
 	}
@@ -297,3 +555,56 @@ void Parameters::smoothen() noexcept
 	
 	panningEqualPower(stereoSmoother.getNextValue(), panL, panR);
 }
+
+//==============================================================================
+ParameterSnapshot Parameters::readCurrentValues() const noexcept
+{
+	ParameterSnapshot snapshot;
+	snapshot.gain = gainValue->load(std::memory_order_relaxed);
+	snapshot.delayTime = delayTimeValue->load(std::memory_order_relaxed);
+	snapshot.mix = mixValue->load(std::memory_order_relaxed);
+	snapshot.feedback = feedbackValue->load(std::memory_order_relaxed);
+	snapshot.stereo = stereoValue->load(std::memory_order_relaxed);
+	snapshot.lowCut = lowCutValue->load(std::memory_order_relaxed);
+	snapshot.highCut = highCutValue->load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+void Parameters::captureSnapshot(int slot)
+{
+	if (slot == 0) {
+		snapshots.a = readCurrentValues();
+		snapshots.hasA = true;
+	} else {
+		snapshots.b = readCurrentValues();
+		snapshots.hasB = true;
+	}
+	
+	snapshots.base = readCurrentValues();
+	
+	publishSnapshots();
+}
+
+void Parameters::clearSnapshots()
+{
+	snapshots = MorphSnapshots();
+	publishSnapshots();
+}
+
+void Parameters::setSnapshots(const MorphSnapshots& newSnapshots)
+{
+	snapshots = newSnapshots;
+	publishSnapshots();
+}
+
+void Parameters::publishSnapshots()
+{
+	// free what the audio thread has let go of
+	MorphSnapshots* retired;
+	while (retiredSnapshots.pop(retired)) {
+		delete retired;
+	}
+	
+	// a copy the audio thread never picked up is still ours to delete
+	delete pendingSnapshots.exchange(new MorphSnapshots(snapshots));
+}
@@ -12,6 +12,7 @@
 
 #include <JuceHeader.h>
 #include "DSP.h"
+#include "Telemetry.h"
 
 /** Parameter IDs **/
 const juce::ParameterID gainParamID { "gain", 1 };
@@ -24,6 +25,47 @@ const juce::ParameterID highCutParamID { "highCut", 1 };
 const juce::ParameterID tempoSyncParamID { "tempoSync", 1 };
 const juce::ParameterID delayNoteParamID { "delayNote", 1 };
 const juce::ParameterID bypassParamID { "bypass", 1 };
+const juce::ParameterID morphParamID { "morph", 2 };
+const juce::ParameterID saturationParamID { "saturation", 2 };
+const juce::ParameterID modRateParamID { "modRate", 2 };
+const juce::ParameterID modDepthParamID { "modDepth", 2 };
+const juce::ParameterID modShapeParamID { "modShape", 2 };
+const juce::ParameterID modPhaseParamID { "modPhase", 2 };
+const juce::ParameterID duckThresholdParamID { "duckThreshold", 2 };
+const juce::ParameterID duckAmountParamID { "duckAmount", 2 };
+const juce::ParameterID duckAttackParamID { "duckAttack", 2 };
+const juce::ParameterID duckReleaseParamID { "duckRelease", 2 };
+const juce::ParameterID sidechainParamID { "sidechain", 2 };
+const juce::ParameterID crossfeedParamID { "crossfeed", 2 };
+const juce::ParameterID crossfeedModeParamID { "crossfeedMode", 2 };
+const juce::ParameterID bypassFeedParamID { "bypassFeed", 2 };
+
+//==============================================================================
+/** plain values of the continuous parameters, used for A/B morphing **/
+struct ParameterSnapshot
+{
+	float gain = 0.f;
+	float delayTime = 100.f;
+	float mix = 100.f;
+	float feedback = 0.f;
+	float stereo = 0.f;
+	float lowCut = 20.f;
+	float highCut = 20000.f;
+};
+
+struct MorphSnapshots
+{
+	ParameterSnapshot a, b;
+	
+	// knob positions when a snapshot was last stored, moving a knob while
+	// morphing offsets the morphed value by how far it moved from here
+	ParameterSnapshot base;
+	
+	bool hasA = false;
+	bool hasB = false;
+	
+	bool isActive() const noexcept { return hasA && hasB; }
+};
 
 //==============================================================================
 /**
@@ -41,9 +83,29 @@ public:
 	void reset() noexcept;
 	void update() noexcept;
 	void smoothen() noexcept;
+	void snapDelayTime() noexcept { delayTime = targetDelayTime; }
+	
+	// bumped by update() whenever any parameter value has changed
+	juce::uint32 getGeneration() const noexcept { return generation; }
+	
+	// values the smoothers are heading towards, used for the tail length
+	float getTargetDelayTime() const noexcept { return targetDelayTime; }
+	float getTargetFeedback() const noexcept { return feedbackSmoother.getTargetValue(); }
+	float getTargetLowCut() const noexcept { return lowCutSmoother.getTargetValue(); }
+	float getTargetHighCut() const noexcept { return highCutSmoother.getTargetValue(); }
+	
+	// A/B snapshots, message thread only; morphing starts once both are stored.
+	// While morphing, Gain, Time, Mix, Feedback, Stereo and the cutoffs follow
+	// the morph, and turning their knobs (or automating them) offsets the
+	// morphed value by how far they moved since a snapshot was last stored
+	void captureSnapshot(int slot);
+	void clearSnapshots();
+	const MorphSnapshots& getSnapshots() const noexcept { return snapshots; }
+	void setSnapshots(const MorphSnapshots& newSnapshots);
 	
 	static constexpr float minDelayTime = 5.f;
 	static constexpr float maxDelayTime = 5000.f;
+	static constexpr float maxModDepth = 10.f;
 	
 	float gain = 0.f;
 	float delayTime = 0.f;
@@ -55,9 +117,37 @@ public:
 	float highCut = 20000.f;
 	
 	int delayNote = 0;
+	int saturation = 0;
+	
+	// delay modulation, the depth is smoothed by the processor
+	float modRate = 0.5f;
+	float modDepth = 0.f;
+	float modPhase = 0.25f;
+	int modShape = 0;
+	
+	// ducking of the wet signal by the dry input
+	float duckThreshold = -30.f;
+	float duckAmount = 0.f;
+	float duckAttack = 10.f;
+	float duckRelease = 250.f;
+	
+	// what the sidechain drives: nothing, ducking, or a feedback gate
+	enum SidechainMode { sidechainOff = 0, sidechainDuck, sidechainGate };
+	int sidechainMode = sidechainOff;
+	
+	// feedback shared between channels on the same side of multichannel
+	// buses, 0..1; spread evenly over the others or rotated to the next one
+	enum CrossfeedMode { crossfeedSpread = 0, crossfeedRotate };
+	float crossfeed = 0.f;
+	int crossfeedMode = crossfeedSpread;
+	
 	bool tempoSync = false;
 	bool bypassed = false;
 	
+	// keep writing into the delay lines while bypassed, so there's a tail
+	// when the effect comes back
+	bool bypassFeedsDelay = false;
+	
 	juce::AudioParameterBool* tempoSyncParam;
 	
 	juce::AudioParameterBool* bypassParam;
@@ -89,6 +179,49 @@ private:
 	
 	juce::AudioParameterChoice* delayNoteParam;
 	
+	juce::AudioParameterFloat* morphParam;
+	
+	// raw values from the APVTS, and what update() saw the last time
+	std::atomic<float>* gainValue = nullptr;
+	std::atomic<float>* delayTimeValue = nullptr;
+	std::atomic<float>* mixValue = nullptr;
+	std::atomic<float>* feedbackValue = nullptr;
+	std::atomic<float>* stereoValue = nullptr;
+	std::atomic<float>* lowCutValue = nullptr;
+	std::atomic<float>* highCutValue = nullptr;
+	std::atomic<float>* tempoSyncValue = nullptr;
+	std::atomic<float>* delayNoteValue = nullptr;
+	std::atomic<float>* bypassValue = nullptr;
+	std::atomic<float>* bypassFeedValue = nullptr;
+	std::atomic<float>* morphValue = nullptr;
+	std::atomic<float>* saturationValue = nullptr;
+	std::atomic<float>* modRateValue = nullptr;
+	std::atomic<float>* modDepthValue = nullptr;
+	std::atomic<float>* modShapeValue = nullptr;
+	std::atomic<float>* modPhaseValue = nullptr;
+	std::atomic<float>* duckThresholdValue = nullptr;
+	std::atomic<float>* duckAmountValue = nullptr;
+	std::atomic<float>* duckAttackValue = nullptr;
+	std::atomic<float>* duckReleaseValue = nullptr;
+	std::atomic<float>* sidechainValue = nullptr;
+	std::atomic<float>* crossfeedValue = nullptr;
+	std::atomic<float>* crossfeedModeValue = nullptr;
+	
+	ParameterSnapshot lastValues;
+	bool forceUpdate = true;
+	juce::uint32 generation = 0;
+	
+	ParameterSnapshot readCurrentValues() const noexcept;
+	void publishSnapshots();
+	
+	// message thread copy, and the copies handed to the audio thread: a new
+	// one is swapped in through pendingSnapshots, the replaced one comes back
+	// through retiredSnapshots so it's never freed on the audio thread
+	MorphSnapshots snapshots;
+	std::atomic<MorphSnapshots*> pendingSnapshots { nullptr };
+	MorphSnapshots* activeSnapshots = nullptr;
+	SpscRing<MorphSnapshots*, 16> retiredSnapshots;
+	
 	//==============================================================================
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Parameters)
 };
@@ -10,7 +10,7 @@
 
 //==============================================================================
 PingPongAudioProcessorComponent::PingPongAudioProcessorComponent (PingPongAudioProcessor& p)
-    : audioProcessor (p), meter(p.levelL, p.levelR)
+    : audioProcessor (p), meter(p.levelL, p.levelR), scope(p.waveform)
 {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
@@ -27,6 +27,7 @@ PingPongAudioProcessorComponent::PingPongAudioProcessorComponent (PingPongAudioP
     tempoSyncButton.setBounds(0, 0, 70, 27);
     tempoSyncButton.setLookAndFeel(ButtonLookAndFeel::get());
     delayGroup.addAndMakeVisible(tempoSyncButton);
+    delayGroup.addAndMakeVisible(scope);
     
     feedbackGroup.setText("Feedback");
     feedbackGroup.setTextLabelPosition(juce::Justification::horizontallyCentred);
@@ -41,11 +42,19 @@ PingPongAudioProcessorComponent::PingPongAudioProcessorComponent (PingPongAudioP
     outputGroup.addAndMakeVisible(gainKnob);
     outputGroup.addAndMakeVisible(mixKnob);
     outputGroup.addAndMakeVisible(meter);
+    
+    // clicking the meter switches between sample peak and true peak
+    meter.onClick = [this] {
+		audioProcessor.setTruePeakMetering(!audioProcessor.isTruePeakMetering());
+	};
     addAndMakeVisible(outputGroup);
     
     // set main look-and-feel
     setLookAndFeel(&mainLNF);
     
+    // the background covers every pixel, so nothing behind needs repainting
+    setOpaque(true);
+    
     juce::Image bypassIcon = juce::ImageCache::getFromMemory(BinaryData::Bypass_png,
 															 BinaryData::Bypass_pngSize);
 	bypassButton.setClickingTogglesState(true);
@@ -88,6 +97,25 @@ void PingPongAudioProcessorComponent::updateDelayKnobs(bool tempoSyncActive)
 
 void PingPongAudioProcessorComponent::paint (juce::Graphics& g)
 {
+	// the cached background is at physical resolution, so this is a 1:1 blit
+	float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	if (backgroundImage.isNull() || !juce::approximatelyEqual(scale, backgroundScale)) {
+		renderBackground(scale);
+	}
+	
+	g.drawImage(backgroundImage, getLocalBounds().toFloat());
+}
+
+void PingPongAudioProcessorComponent::renderBackground(float scale)
+{
+	int width = std::max(1, juce::roundToInt(float(getWidth()) * scale));
+	int height = std::max(1, juce::roundToInt(float(getHeight()) * scale));
+	backgroundImage = juce::Image(juce::Image::RGB, width, height, false);
+	backgroundScale = scale;
+	
+	juce::Graphics g { backgroundImage };
+	g.addTransform(juce::AffineTransform::scale(scale));
+	
 	// fill background
 	//g.fillAll(Colors::background);
 	g.setGradientFill(juce::ColourGradient::vertical(Colors::backgroundTop, 40, Colors::backgroundBottom, getHeight()));
@@ -149,44 +177,64 @@ void PingPongAudioProcessorComponent::resized()
     lowCutKnob.setTopLeftPosition(feedbackKnob.getX(), feedbackKnob.getBottom() + 10);
     highCutKnob.setTopLeftPosition(lowCutKnob.getRight() + 20, lowCutKnob.getY());
     
+    // position the delay buffer scope below the sync button
+    scope.setBounds(10, tempoSyncButton.getBottom() + 10,
+					delayGroup.getWidth() - 20, delayGroup.getHeight() - tempoSyncButton.getBottom() - 20);
+    
     // position the meter
     meter.setBounds(outputGroup.getWidth() - 45, 30, 30, gainKnob.getBottom() - 30);
     
     // position bypass button
     bypassButton.setTopLeftPosition(getRight() - bypassButton.getWidth() - 10, 10);
+    
+    // size changed, composite the background again on the next paint
+    backgroundImage = juce::Image();
 }
 
 //==============================================================================
 ResizeablePingPongAudioProcessorEditor::ResizeablePingPongAudioProcessorEditor(PingPongAudioProcessor& p)
-	: juce::AudioProcessorEditor(p), pingPongComponent(p)
+	: juce::AudioProcessorEditor(p), audioProcessor(p), pingPongComponent(p)
 {
-	// set up options file for saving window size
-	juce::PropertiesFile::Options options;
-    options.applicationName = ProjectInfo::projectName;
-    options.folderName = ProjectInfo::companyName;
-    options.commonToAllUsers = true;
-    options.filenameSuffix = "settings";
-    options.osxLibrarySubFolder = "Application Support";
-    
-    applicationProperties.setStorageParameters(options);
-    
-    // get scale value and set to 1.0 if no value is found
-    double scale = 1.0;
-    if (juce::PropertiesFile* properties = applicationProperties.getCommonSettings(true)) {
-		scale = properties->getDoubleValue("ScaleFactor", 1.0);
-    }
-    
 	addAndMakeVisible(pingPongComponent);
 	
 	// set up window and resize limits
-	setSize(int(pluginWidth * scale), int(pluginHeight * scale));
+	setSize(pluginWidth, pluginHeight);
     setResizable(true, true);
     setResizeLimits(pluginWidth, pluginHeight, pluginWidth * 2, pluginHeight * 2);
     getConstrainer()->setFixedAspectRatio(pluginWidth / float(pluginHeight));
+    
+    // right-clicking the background opens the editor options
+    pingPongComponent.addMouseListener(this, false);
+    
+    // settings are read in the background, apply them once they're in
+    if (settings->isLoaded()) {
+		applySettings();
+	} else {
+		settings->addChangeListener(this);
+	}
 }
 
 ResizeablePingPongAudioProcessorEditor::~ResizeablePingPongAudioProcessorEditor()
 {
+	settings->removeChangeListener(this);
+	pingPongComponent.removeMouseListener(this);
+	setOpenGLRendering(false);
+}
+
+void ResizeablePingPongAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+	settings->removeChangeListener(this);
+	applySettings();
+}
+
+void ResizeablePingPongAudioProcessorEditor::applySettings()
+{
+	// get scale value and set to 1.0 if no value is found
+	double scale = settings->getValue("ScaleFactor", 1.0);
+	setSize(int(pluginWidth * scale), int(pluginHeight * scale));
+	
+	// GPU rendering is opt-in, software rendering is the fallback
+	setOpenGLRendering(settings->getValue("OpenGL", false));
 }
 
 //==============================================================================
@@ -195,9 +243,10 @@ void ResizeablePingPongAudioProcessorEditor::resized()
 	// set scale factor based on window width
 	const float scaleFactor = getWidth() / float(pluginWidth);
 	
-	// set scale if options file exists
-	if (juce::PropertiesFile* properties = applicationProperties.getCommonSettings(true)) {
-		properties->setValue("ScaleFactor", scaleFactor);
+	// remembered in the cache, the file is written once resizing has settled;
+	// before the settings are in, this is only the default size
+	if (settings->isLoaded()) {
+		settings->setValue("ScaleFactor", scaleFactor);
 	}
 	
 	// transform window and set its bounds
@@ -208,3 +257,102 @@ void ResizeablePingPongAudioProcessorEditor::resized()
 	DBG("Scale Factor: " << scaleFactor << '\n');
 	DBG("Window Bounds: " << getBounds().toString() << '\n');
 }
+
+void ResizeablePingPongAudioProcessorEditor::mouseDown(const juce::MouseEvent& event)
+{
+	if (!event.mods.isPopupMenu()) { return; }
+	
+	juce::PopupMenu menu;
+	menu.addItem("GPU Rendering (OpenGL)", isOpenGLAvailable(), openGLRendering, [this]
+	{
+		setOpenGLRendering(!openGLRendering);
+		settings->setValue("OpenGL", openGLRendering);
+	});
+	
+	// A/B morphing, the Morph parameter blends between the two snapshots
+	Parameters& params = audioProcessor.params;
+	menu.addSeparator();
+	menu.addItem("Store Snapshot A", [&params] { params.captureSnapshot(0); });
+	menu.addItem("Store Snapshot B", [&params] { params.captureSnapshot(1); });
+	menu.addItem("Clear Snapshots", params.getSnapshots().hasA || params.getSnapshots().hasB,
+				 false, [&params] { params.clearSnapshots(); });
+	
+	menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
+
+// set once a context failed to come up, GL stays off for the rest of the process
+static std::atomic<bool> openGLFailed { false };
+
+void ResizeablePingPongAudioProcessorEditor::setOpenGLRendering(bool shouldUseOpenGL)
+{
+   #if JUCE_MODULE_AVAILABLE_juce_opengl
+	shouldUseOpenGL = shouldUseOpenGL && isOpenGLAvailable();
+	
+	if (shouldUseOpenGL == openGLRendering) { return; }
+	
+	// composite the whole editor, meters and scaled knobs on the GPU; the
+	// context is created asynchronously, so wait for it to report back
+	if (shouldUseOpenGL) {
+		contextWatcher.created.store(false);
+		contextWaitMs = 0;
+		openGLContext.setRenderer(&contextWatcher);
+		openGLContext.attachTo(*this);
+		startTimer(contextCheckMs);
+	} else {
+		stopTimer();
+		openGLContext.detach();
+		openGLContext.setRenderer(nullptr);
+	}
+	
+	openGLRendering = shouldUseOpenGL;
+   #else
+	juce::ignoreUnused(shouldUseOpenGL);
+   #endif
+}
+
+void ResizeablePingPongAudioProcessorEditor::timerCallback()
+{
+   #if JUCE_MODULE_AVAILABLE_juce_opengl
+	if (contextWatcher.created.load()) {
+		stopTimer();
+		return;
+	}
+	
+	// the context isn't created before the editor is on screen, only count
+	// the time it's showing
+	if (isShowing()) {
+		contextWaitMs += contextCheckMs;
+	}
+	
+	// attached but never came up: nothing would be drawn, go back to the
+	// software renderer and keep the menu item disabled from now on
+	if (contextWaitMs >= contextTimeoutMs) {
+		DBG("OpenGL context wasn't created, falling back to software rendering");
+		openGLFailed.store(true);
+		setOpenGLRendering(false);
+	}
+   #else
+	stopTimer();
+   #endif
+}
+
+bool ResizeablePingPongAudioProcessorEditor::isOpenGLAvailable()
+{
+   #if ! JUCE_MODULE_AVAILABLE_juce_opengl
+	return false;
+   #else
+	if (openGLFailed.load()) { return false; }
+	
+    #if JUCE_LINUX || JUCE_BSD
+	// headless boxes and some remote sessions have no GL driver at all
+	static const bool available = []
+	{
+		juce::DynamicLibrary gl;
+		return gl.open("libGL.so.1");
+	}();
+	return available;
+    #else
+	return true;
+    #endif
+   #endif
+}
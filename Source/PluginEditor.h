@@ -14,6 +14,8 @@
 #include "RotaryKnob.h"
 #include "LookAndFeel.h"
 #include "LevelMeter.h"
+#include "DelayScope.h"
+#include "EditorSettings.h"
 
 //==============================================================================
 /**
@@ -33,6 +35,7 @@ private:
     void parameterValueChanged(int, float) override;
     void parameterGestureChanged(int, bool) override { }
     void updateDelayKnobs(bool tempoSyncActive);
+    void renderBackground(float scale);
     
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -59,12 +62,18 @@ private:
     
     LevelMeter meter;
     
+    DelayScope scope;
+    
     juce::ImageButton bypassButton;
     
     juce::AudioProcessorValueTreeState::ButtonAttachment bypassAttachment {
 		audioProcessor.apvts, bypassParamID.getParamID(), bypassButton
 	};
     
+    // gradient and logo, composited once per size and pixel scale
+    juce::Image backgroundImage;
+    float backgroundScale = 0.f;
+    
 	//==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PingPongAudioProcessorComponent)
 };
@@ -72,7 +81,9 @@ private:
 //==============================================================================
 /**
 */
-class ResizeablePingPongAudioProcessorEditor  : public juce::AudioProcessorEditor
+class ResizeablePingPongAudioProcessorEditor  : public juce::AudioProcessorEditor,
+												private juce::ChangeListener,
+												private juce::Timer
 {
 public:
 	ResizeablePingPongAudioProcessorEditor(PingPongAudioProcessor&);
@@ -80,11 +91,41 @@ public:
 	
 	//==============================================================================
 	void resized() override;
+	void mouseDown(const juce::MouseEvent& event) override;
 	
 private:
+	void changeListenerCallback(juce::ChangeBroadcaster*) override;
+	void timerCallback() override;
+	void applySettings();
+	void setOpenGLRendering(bool shouldUseOpenGL);
+	static bool isOpenGLAvailable();
+	
+	PingPongAudioProcessor& audioProcessor;
 	PingPongAudioProcessorComponent pingPongComponent;
 	
-	juce::ApplicationProperties applicationProperties;
+   #if JUCE_MODULE_AVAILABLE_juce_opengl
+	// reports from the GL thread that the context really came up, a loadable
+	// driver doesn't mean a context can be created
+	struct ContextWatcher  : juce::OpenGLRenderer
+	{
+		void newOpenGLContextCreated() override { created.store(true); }
+		void renderOpenGL() override { juce::OpenGLHelpers::clear(juce::Colours::black); }
+		void openGLContextClosing() override {}
+		
+		std::atomic<bool> created { false };
+	};
+	
+	ContextWatcher contextWatcher;
+	juce::OpenGLContext openGLContext;
+   #endif
+	bool openGLRendering = false;
+	
+	// time on screen without a context before falling back to software
+	static constexpr int contextCheckMs = 100;
+	static constexpr int contextTimeoutMs = 2000;
+	int contextWaitMs = 0;
+	
+	juce::SharedResourcePointer<EditorSettings> settings;
 	
 	static constexpr int pluginWidth = 500;
 	static constexpr int pluginHeight = 330;
@@ -14,6 +14,7 @@ PingPongAudioProcessor::PingPongAudioProcessor() :
 	AudioProcessor(
 		BusesProperties()
 			.withInput("Input",  juce::AudioChannelSet::stereo(), true)
+			.withInput("Sidechain", juce::AudioChannelSet::stereo(), false)
 			.withOutput("Output", juce::AudioChannelSet::stereo(), true)
 	),
 	params(apvts)
@@ -62,7 +63,7 @@ bool PingPongAudioProcessor::isMidiEffect() const
 
 double PingPongAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailSeconds.load();
 }
 
 int PingPongAudioProcessor::getNumPrograms()
@@ -103,29 +104,32 @@ void PingPongAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = juce::uint32(samplesPerBlock);
-    spec.numChannels = 2;
+    
+    // one delay channel per output channel, grouped by speaker position
+    preparedChannels = juce::jlimit(1, maxChannels, getMainBusNumOutputChannels());
+    spec.numChannels = juce::uint32(preparedChannels);
+    updateChannelGroups(getChannelLayoutOfBus(false, 0));
     
     /** prepare juce::dsp objects **/
     // delayLine.prepare(spec);
     
-    // allocate enough memory for maxDelayTime milliseconds
-    double numSamples = (Parameters::maxDelayTime / 1000.0) * sampleRate;
+    // allocate enough memory for maxDelayTime milliseconds plus the modulation depth
+    double numSamples = ((Parameters::maxDelayTime + Parameters::maxModDepth) / 1000.0) * sampleRate;
     int maxDelayInSamples = int(std::ceil(numSamples));
     
 //    delayLine.setMaximumDelayInSamples(maxDelayInSamples);
 //    delayLine.reset();
     
-    delayLineL.setMaximumDelayInSamples(maxDelayInSamples);
-    delayLineR.setMaximumDelayInSamples(maxDelayInSamples);
-    delayLineL.reset();
-    delayLineR.reset();
+    delayLine.setMaximumDelayInSamples(maxDelayInSamples, preparedChannels);
+    delayLine.reset();
+    
+    waveform.prepare(delayLine.getBufferLength());
     
     // Debugging statements for maxDelayInSamples -> should be 220500Hz for sample rate of 44100Hz
 	DBG("Sample Rate: " << sampleRate << "Hz\n");
 	DBG("Max Delay (samples): " << maxDelayInSamples << "Hz\n");
 	
-	feedbackL = 0.f;
-	feedbackR = 0.f;
+	feedback.fill(0.f);
 	
 	lowCutFilter.prepare(spec);
 	lowCutFilter.reset();
@@ -133,6 +137,16 @@ void PingPongAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
 	highCutFilter.prepare(spec);
 	highCutFilter.reset();
 	
+	for (Saturator& saturator : saturators) {
+		saturator.reset();
+	}
+	
+	outputGuard.prepare(sampleRate);
+	
+	lfo.prepare(sampleRate);
+	ducker.prepare(sampleRate);
+	modDepthInSamples = 0.f;
+	
 	lastLowCut = -1.f;
 	lastHighCut = -1.f;
 	
@@ -140,11 +154,31 @@ void PingPongAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
 	
 	levelL.reset();
 	levelR.reset();
+	truePeakL.reset();
+	truePeakR.reset();
 	
 	delayInSamples = 0.f;
 	targetDelay = 0.f;
 	xfade = 0.f;
 	xfadeInc = float(1.0 / (0.05 * sampleRate)); // 50 ms
+	bypassInc = float(1.0 / (0.01 * sampleRate)); // 10 ms
+	
+	// force a parameter update on the first sample
+	samplesUntilUpdate = 0;
+	
+	// read the parameters once so the tail length is known before the first block
+	params.update();
+	bypassMix = params.bypassed ? 1.f : 0.f;
+	bypassSkipping = false;
+	feedbackPeak = 0.f;
+	quietSamples = 0;
+	idle = false;
+	tailTempo = 0.0;
+	updateTailLength();
+	
+   #if PINGPONG_DETERMINISTIC
+	outputHash = hashOffsetBasis;
+   #endif
 }
 
 void PingPongAudioProcessor::releaseResources()
@@ -160,16 +194,26 @@ bool PingPongAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 	const juce::AudioChannelSet mainIn = layouts.getMainInputChannelSet();
 	const juce::AudioChannelSet mainOut = layouts.getMainOutputChannelSet();
 	
+	// the sidechain is optional, mono or stereo when it's enabled
+	if (layouts.inputBuses.size() > 1) {
+		const juce::AudioChannelSet sidechain = layouts.getChannelSet(true, 1);
+		
+		if (!sidechain.isDisabled() && sidechain != mono && sidechain != stereo) { return false; }
+	}
+	
+	if (mainOut.isDisabled() || mainOut.size() > maxChannels) { return false; }
+	
 	if (mainIn == mono && mainOut == mono) { return true; }
 	if (mainIn == mono && mainOut == stereo) { return true; }
-	if (mainIn == stereo && mainOut == stereo) { return true; }
 	
-	return false;
+	// surround and ambisonic layouts, see updateChannelGroups()
+	return mainIn == mainOut;
 }
 
 void PingPongAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_unused]] juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -189,176 +233,636 @@ void PingPongAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[m
     // Alternatively, you can process the samples with the channels
     // interleaved by keeping the same state.
     
-    // update parameters
-    params.update();
-    
     // update tempo from playhead
     tempo.update(getPlayHead());
     
-    float syncedTime = float(tempo.getMillisecondsForNoteLength(params.delayNote));
-    if (syncedTime > Parameters::maxDelayTime) {
-		syncedTime = Parameters::maxDelayTime;
-	}
-    
-    float sampleRate = float(getSampleRate());
-    
     // input
     juce::AudioBuffer<float> mainInput = getBusBuffer(buffer, true, 0);
     int mainInputChannels = mainInput.getNumChannels();
-    bool isMainInputStereo = mainInputChannels > 1;
-    const float* inputDataL = mainInput.getReadPointer(0);
-    const float* inputDataR = mainInput.getReadPointer(isMainInputStereo ? 1 : 0);
     
     // output
     juce::AudioBuffer<float> mainOutput = getBusBuffer(buffer, false, 0);
-    int mainOutputChannels = mainOutput.getNumChannels();
+    int mainOutputChannels = std::min(mainOutput.getNumChannels(), preparedChannels);
     bool isMainOutputStereo = mainOutputChannels > 1;
     float* outputDataL = mainOutput.getWritePointer(0);
     float* outputDataR = mainOutput.getWritePointer(isMainOutputStereo ? 1 : 0);
     
-    float maxL = 0.f;
-    float maxR = 0.f;
+    // a mono input feeds every channel
+    std::array<const float*, maxChannels> inputData {};
+    std::array<float*, maxChannels> outputData {};
+    
+    for (int channel = 0; channel < mainOutputChannels; ++channel) {
+        inputData[size_t(channel)] = mainInput.getReadPointer(std::min(channel, mainInputChannels - 1));
+        outputData[size_t(channel)] = mainOutput.getWritePointer(channel);
+    }
+    
+    // sidechain, refers to the host's channels so there's no copy
+    const float* keyDataL = nullptr;
+    const float* keyDataR = nullptr;
+    
+    if (params.sidechainMode != Parameters::sidechainOff && getBusCount(true) > 1) {
+        juce::AudioBuffer<float> sidechain = getBusBuffer(buffer, true, 1);
+        
+        if (sidechain.getNumChannels() > 0) {
+            keyDataL = sidechain.getReadPointer(0);
+            keyDataR = sidechain.getReadPointer(sidechain.getNumChannels() > 1 ? 1 : 0);
+        }
+    }
+    
+    int numSamples = buffer.getNumSamples();
+    
+    BlockTelemetry record;
+    record.numSamples = numSamples;
     
-    // stereo processing
-    if (isMainOutputStereo) {
-		for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-			// smoothen parameters
-			params.smoothen();
+    // skip all DSP while the input is silent and nothing audible is left
+    // inside the delay period, wake up again on the first non-silent block;
+    // the longest read includes the modulation depth
+    float inputLevel = mainInput.getMagnitude(0, numSamples);
+    float delayPeriod = std::max(delayInSamples, targetDelay) + modDepthInSamples + 1.f;
+    
+   #if PINGPONG_DETERMINISTIC
+    // going idle is decided per host block and stops the LFO and smoothers,
+    // so the render would depend on the block size
+    constexpr bool canIdle = false;
+   #else
+    constexpr bool canIdle = true;
+   #endif
+    
+    if (canIdle && inputLevel < silenceThreshold && float(quietSamples) > delayPeriod) {
+		if (!idle) {
+			// whatever is left in the delay lines is below the threshold
+			resetDelayState();
+			idle = true;
+		}
+		
+		// pass the dry input through, a mono input may not be in every output yet
+		for (size_t channel = 0; channel < size_t(mainOutputChannels); ++channel) {
+			if (outputData[channel] != inputData[channel]) {
+				juce::FloatVectorOperations::copy(outputData[channel], inputData[channel], numSamples);
+			}
+		}
+		
+		// keep the parameter update grid in step with the stream
+		samplesUntilUpdate -= numSamples % parameterUpdateInterval;
+		if (samplesUntilUpdate < 0) {
+			samplesUntilUpdate += parameterUpdateInterval;
+		}
+	} else {
+		idle = false;
+		
+		// split the block on a fixed grid of parameter updates that is anchored to
+		// the stream position, so automation lands on the same samples whatever
+		// buffer size the host uses
+		int offset = 0;
+		bool isProcessed = false;
+		
+		while (offset < numSamples) {
+			if (samplesUntilUpdate == 0) {
+				params.update();
+				updateTailLength();
+				samplesUntilUpdate = parameterUpdateInterval;
+				
+				if (presetSwitchPending.exchange(false)) {
+					switchPreset();
+				}
+				
+				// the whole cell's modulation at once, so a host block edge
+				// inside the cell doesn't restart the oscillator
+				computeModulation();
+			}
 			
-			if (params.tempoSync) {
+			int cellOffset = parameterUpdateInterval - samplesUntilUpdate;
+			int count = std::min(numSamples - offset, samplesUntilUpdate);
 			
-				if (xfade == 0.f) {
-					targetDelay = syncedTime / 1000.f * sampleRate;
-					
-					// first time
-					if (delayInSamples == 0.f) {
-						delayInSamples = targetDelay;
-					}
-					
-					// start cross fade
-					else if (!juce::approximatelyEqual(targetDelay, delayInSamples)) {
-						xfade = xfadeInc;
+			// mono, stereo and multichannel all run through the same engine,
+			// a single mono channel is a plain feedback delay
+			std::array<const float*, maxChannels> chunkInput;
+			std::array<float*, maxChannels> chunkOutput;
+			
+			for (size_t channel = 0; channel < size_t(mainOutputChannels); ++channel) {
+				chunkInput[channel] = inputData[channel] + offset;
+				chunkOutput[channel] = outputData[channel] + offset;
+			}
+			
+			if (params.bypassed && bypassMix >= 1.f && !params.bypassFeedsDelay) {
+				// fully bypassed: no DSP, the input goes straight through; the
+				// delay lines are emptied so nothing stale comes back later
+				if (!bypassSkipping) {
+					resetDelayState();
+					bypassSkipping = true;
+				}
+				
+				for (size_t channel = 0; channel < size_t(mainOutputChannels); ++channel) {
+					if (chunkOutput[channel] != chunkInput[channel]) {
+						juce::FloatVectorOperations::copy(chunkOutput[channel], chunkInput[channel], count);
 					}
 				}
 			} else {
-				// set delay using delayTime
-				delayInSamples = params.delayTime / 1000.f * sampleRate;
-				// delayLine.setDelay(delay);
+				bypassSkipping = false;
+				isProcessed = true;
+				
+				processChannels(chunkInput.data(), chunkOutput.data(), mainOutputChannels,
+								keyDataL != nullptr ? keyDataL + offset : nullptr,
+								keyDataR != nullptr ? keyDataR + offset : nullptr,
+								cellOffset, count);
 			}
 			
-			// set cutoff freqs
-			if (!juce::approximatelyEqual(params.lowCut, lastLowCut)) {
-				lowCutFilter.setCutoffFrequency(params.lowCut);
-				lastLowCut = params.lowCut;
-			}
+			offset += count;
+			samplesUntilUpdate -= count;
+		}
+		
+		// a NaN or Inf would otherwise circulate in the feedback loop forever,
+		// a block that was passed straight through is left untouched
+		if (isProcessed && !outputGuard.process(mainOutput)) {
+			resetDelayState();
+		}
+		
+		// meter the output once per block, mono feeds both sides of the meter
+		measureOutput(outputDataL, outputDataR, numSamples, record);
+	}
+	
+	// fold what was written into the delay lines into the waveform summary
+	waveform.push(delayLine, numSamples);
+	
+	// energy tracker for silence detection
+	if (inputLevel < silenceThreshold && feedbackPeak < silenceThreshold) {
+		quietSamples += numSamples;
+	} else {
+		quietSamples = 0;
+	}
+	feedbackPeak = 0.f;
+	
+   #if PINGPONG_DETERMINISTIC
+	updateOutputHash(mainOutput);
+   #endif
+	
+	// publish the block record, dropped if nobody is draining the ring
+	record.delayInSamples = delayInSamples;
+	record.crossfade = xfade;
+	record.idle = idle;
+	record.processingTime = juce::Time::highResolutionTicksToSeconds(
+		juce::Time::getHighResolutionTicks() - startTicks);
+	telemetry.push(record);
+}
+
+void PingPongAudioProcessor::resetDelayState() noexcept
+{
+	delayLine.reset();
+	feedback.fill(0.f);
+	lowCutFilter.reset();
+	highCutFilter.reset();
+	ducker.reset();
+	
+	for (Saturator& saturator : saturators) {
+		saturator.reset();
+	}
+}
+
+/* speaker positions that ping-pong with each other, left member first */
+static constexpr std::pair<juce::AudioChannelSet::ChannelType, juce::AudioChannelSet::ChannelType> mirroredChannels[] = {
+	{ juce::AudioChannelSet::left, juce::AudioChannelSet::right },
+	{ juce::AudioChannelSet::leftCentre, juce::AudioChannelSet::rightCentre },
+	{ juce::AudioChannelSet::wideLeft, juce::AudioChannelSet::wideRight },
+	{ juce::AudioChannelSet::leftSurround, juce::AudioChannelSet::rightSurround },
+	{ juce::AudioChannelSet::leftSurroundSide, juce::AudioChannelSet::rightSurroundSide },
+	{ juce::AudioChannelSet::leftSurroundRear, juce::AudioChannelSet::rightSurroundRear },
+	{ juce::AudioChannelSet::topFrontLeft, juce::AudioChannelSet::topFrontRight },
+	{ juce::AudioChannelSet::topSideLeft, juce::AudioChannelSet::topSideRight },
+	{ juce::AudioChannelSet::topRearLeft, juce::AudioChannelSet::topRearRight },
+	{ juce::AudioChannelSet::bottomFrontLeft, juce::AudioChannelSet::bottomFrontRight },
+	{ juce::AudioChannelSet::bottomSideLeft, juce::AudioChannelSet::bottomSideRight },
+	{ juce::AudioChannelSet::bottomRearLeft, juce::AudioChannelSet::bottomRearRight },
+};
+
+void PingPongAudioProcessor::updateChannelGroups(const juce::AudioChannelSet& layout) noexcept
+{
+	numGroups = 0;
+	channelSides.fill(-1);
+	
+	for (int channel = 0; channel < preparedChannels; ++channel) {
+		if (channelSides[size_t(channel)] >= 0) { continue; }
+		
+		juce::AudioChannelSet::ChannelType type = layout.getTypeOfChannel(channel);
+		
+		// the sub gets no echoes
+		if (type == juce::AudioChannelSet::LFE || type == juce::AudioChannelSet::LFE2) {
+			channelSides[size_t(channel)] = sideDry;
+			continue;
+		}
+		
+		ChannelGroup group { channel, channel };
+		
+		for (const auto& [left, right] : mirroredChannels) {
+			if (type != left && type != right) { continue; }
+			
+			int partner = layout.getChannelIndexForType(type == left ? right : left);
 			
-			if (!juce::approximatelyEqual(params.highCut, lastHighCut)) {
-				highCutFilter.setCutoffFrequency(params.highCut);
-				lastHighCut = params.highCut;
+			if (partner > channel && partner < preparedChannels) {
+				group.left = type == left ? channel : partner;
+				group.right = type == left ? partner : channel;
 			}
+			break;
+		}
 		
-			// Use delayLine to push and pop samples
-			float dryL = inputDataL[sample];
-			float dryR = inputDataR[sample];
+		// centre, ambisonic and discrete channels, or a half of a missing pair
+		if (group.left == group.right) {
+			channelSides[size_t(channel)] = sideSingle;
+		} else {
+			channelSides[size_t(group.left)] = sideLeft;
+			channelSides[size_t(group.right)] = sideRight;
+		}
 		
-			// convert to mono
-			float mono = (dryL + dryR) * 0.5f;
+		groups[size_t(numGroups++)] = group;
+	}
+	
+	// cross-feed mixes each side on its own, in group order
+	numSideMembers.fill(0);
+	
+	auto addMember = [this](int channel)
+	{
+		size_t side = size_t(channelSides[size_t(channel)]);
+		sideMembers[side][size_t(numSideMembers[side]++)] = channel;
+	};
+	
+	for (int group = 0; group < numGroups; ++group) {
+		const ChannelGroup& channels = groups[size_t(group)];
+		addMember(channels.left);
 		
-			// add feedback to dry mix
-//			delayLine.pushSample(0, mono * params.panL + feedbackR);
-//			delayLine.pushSample(1, mono * params.panR + feedbackL);
-			
-			delayLineL.write(mono * params.panL + feedbackR);
-			delayLineR.write(mono * params.panR + feedbackL);
+		if (channels.right != channels.left) {
+			addMember(channels.right);
+		}
+	}
+	
+	// cross-feed only does something with two or more channels on one side
+	hasCrossfeedPartners = *std::max_element(numSideMembers.begin(), numSideMembers.end()) > 1;
+}
+
+void PingPongAudioProcessor::mixCrossfeed() noexcept
+{
+	float amount = params.crossfeed;
+	float ownGain = 1.f - amount;
+	
+	for (size_t side = 0; side < sideMembers.size(); ++side) {
+		const std::array<int, maxChannels>& members = sideMembers[side];
+		int numMembers = numSideMembers[side];
 		
-//			float wetL = delayLine.popSample(0);
-//			float wetR = delayLine.popSample(1);
+		// alone on its side: keeps all of its own feedback
+		if (numMembers < 2) { continue; }
+		
+		if (params.crossfeedMode == Parameters::crossfeedRotate) {
+			// receives x from the previous member only, so echoes travel round
+			float previous = feedback[size_t(members[size_t(numMembers - 1)])];
+			
+			for (size_t i = 0; i < size_t(numMembers); ++i) {
+				float& value = feedback[size_t(members[i])];
+				float current = value;
+				value = ownGain * current + amount * previous;
+				previous = current;
+			}
+		} else {
+			// receives x spread evenly over the other members
+			float otherGain = amount / float(numMembers - 1);
+			float sum = 0.f;
+			
+			for (size_t i = 0; i < size_t(numMembers); ++i) {
+				sum += feedback[size_t(members[i])];
+			}
 			
-			float wetL = delayLineL.read(delayInSamples);
-			float wetR = delayLineR.read(delayInSamples);
+			for (size_t i = 0; i < size_t(numMembers); ++i) {
+				float& value = feedback[size_t(members[i])];
+				value = ownGain * value + otherGain * (sum - value);
+			}
+		}
+	}
+}
 
-			// crossfading ??
-			if (xfade > 0.f) {
-				float newL = delayLineL.read(targetDelay);
-				float newR = delayLineR.read(targetDelay);
-				
-				wetL = (1.f - xfade) * wetL + xfade * newL;
-				wetR = (1.f - xfade) * wetR + xfade * newR;
-				
-				xfade += xfadeInc;
+void PingPongAudioProcessor::processChannels(const float* const* inputData, float* const* outputData,
+											 int numChannels, const float* keyDataL, const float* keyDataR,
+											 int cellOffset, int numSamples) noexcept
+{
+	float syncedTime = getSyncedTime();
+	float sampleRate = float(getSampleRate());
+	float peak = feedbackPeak;
+	
+	for (size_t group = 0; group < size_t(numGroups); ++group) {
+		saturators[group].setMode(params.saturation);
+	}
+	
+	ducker.setParameters(params.duckThreshold, params.duckAmount,
+						  params.duckAttack, params.duckRelease);
+	
+	// the side lists cover the prepared layout
+	bool isCrossfed = hasCrossfeedPartners && params.crossfeed > 0.f && numChannels == preparedChannels;
+	
+	// dry channels are never written or read, they stay silent in the delay
+	std::array<float, maxChannels> dry;
+	std::array<float, maxChannels> frame {};
+	std::array<float, maxChannels> wet {};
+	
+	for (int sample = 0; sample < numSamples; ++sample) {
+		// smoothen parameters
+		params.smoothen();
+		
+		if (params.tempoSync) {
+		
+			if (xfade == 0.f) {
+				targetDelay = syncedTime / 1000.f * sampleRate;
 				
-				// done fading...
-				if (xfade >= 1.f) {
+				// first time
+				if (delayInSamples == 0.f) {
 					delayInSamples = targetDelay;
-					xfade = 0.f;
+				}
+				
+				// start cross fade
+				else if (!juce::approximatelyEqual(targetDelay, delayInSamples)) {
+					xfade = xfadeInc;
 				}
 			}
+		} else if (xfade == 0.f) {
+			// set delay using delayTime
+			delayInSamples = params.delayTime / 1000.f * sampleRate;
+			// delayLine.setDelay(delay);
+		}
 		
-			// get feedback from wet mix
-			feedbackL = wetL * params.feedback;
-			feedbackL = lowCutFilter.processSample(0, feedbackL);
-			feedbackL = highCutFilter.processSample(0, feedbackL);
-			
-			feedbackR = wetR * params.feedback;
-			feedbackR = lowCutFilter.processSample(1, feedbackR);
-			feedbackR = highCutFilter.processSample(1, feedbackR);
+		// set cutoff freqs
+		if (!juce::approximatelyEqual(params.lowCut, lastLowCut)) {
+			lowCutFilter.setCutoffFrequency(params.lowCut);
+			lastLowCut = params.lowCut;
+		}
 		
-			// always 100% dry, 0-100% wet mixing
-			float mixL = dryL + wetL * params.mix;
-			float mixR = dryR + wetR * params.mix;
-
-			// send effect mixing
-//			float mixL = dryL * (1.f - params.mix) + wetL * params.mix;
-//			float mixR = dryR * (1.f - params.mix) + wetR * params.mix;
+		if (!juce::approximatelyEqual(params.highCut, lastHighCut)) {
+			highCutFilter.setCutoffFrequency(params.highCut);
+			lastHighCut = params.highCut;
+		}
+		
+		// read the inputs before any output is written, they may share memory
+		for (size_t channel = 0; channel < size_t(numChannels); ++channel) {
+			dry[channel] = inputData[channel][sample];
+		}
 		
-			// write dry/wet delay signal to buffer with output gain
-			float outL = mixL * params.gain;
-			float outR = mixR * params.gain;
+		// each pair sums to mono, pans it and adds the other side's feedback
+		float monoSum = 0.f;
+		
+		for (size_t group = 0; group < size_t(numGroups); ++group) {
+			size_t left = size_t(groups[group].left);
+			size_t right = size_t(groups[group].right);
 			
-			if (params.bypassed) {
-				outL = dryL;
-				outR = dryR;
-			}
+			// the host handed over fewer channels than were prepared
+			if (right >= size_t(numChannels)) { continue; }
 			
-			outputDataL[sample] = outL;
-			outputDataR[sample] = outR;
+			// convert to mono
+			float mono = (dry[left] + dry[right]) * 0.5f;
+			monoSum += mono;
 			
-			maxL = std::max(maxL, std::abs(outL));
-			maxR = std::max(maxR, std::abs(outR));
+			if (right == left) {
+				frame[left] = mono + feedback[left];
+			} else {
+				frame[left] = mono * params.panL + feedback[right];
+				frame[right] = mono * params.panR + feedback[left];
+			}
 		}
 		
-		levelL.updateIfGreater(maxL);
-		levelR.updateIfGreater(maxR);
+		// the sidechain, or the dry input without one, either ducks the wet
+		// signal or gates the feedback
+		float key = keyDataL != nullptr ? (keyDataL[sample] + keyDataR[sample]) * 0.5f
+										: monoSum / float(std::max(1, numGroups));
+		float duck = 1.f;
+		float gate = 1.f;
 		
-	// mono processing
-	} else {
-		for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-			params.smoothen();
+		if (params.sidechainMode == Parameters::sidechainGate) {
+			gate = ducker.processGate(key);
+		} else {
+			duck = ducker.process(key);
+		}
+		
+		delayLine.write(frame.data());
+		
+		// right channels of each pair follow modR, everything else modL
+		for (size_t channel = 0; channel < size_t(numChannels); ++channel) {
+			if (channelSides[channel] == sideDry) { continue; }
 			
-			delayInSamples = params.delayTime / 1000.f * sampleRate;
-			// delayLine.setDelay(delayInSamples);
+			size_t index = size_t(cellOffset + sample);
+			float mod = channelSides[channel] == sideRight ? modR[index] : modL[index];
+			wet[channel] = delayLine.read(int(channel), delayInSamples + mod);
 			
-			float dry = inputDataL[sample];
-			// delayLine.pushSample(0, dry + feedbackL);
+			// crossfading ??
+			if (xfade > 0.f) {
+				float next = delayLine.read(int(channel), targetDelay + mod);
+				wet[channel] = (1.f - xfade) * wet[channel] + xfade * next;
+			}
+		}
+		
+		if (xfade > 0.f) {
+			xfade += xfadeInc;
 			
-			delayLineL.write(dry + feedbackL);
+			// done fading...
+			if (xfade >= 1.f) {
+				delayInSamples = targetDelay;
+				xfade = 0.f;
+			}
+		}
+		
+		// get feedback from wet mix
+		float feedbackGain = params.feedback * gate;
+		
+		for (size_t channel = 0; channel < size_t(numChannels); ++channel) {
+			if (channelSides[channel] == sideDry) { continue; }
 			
-			// float wet = delayLine.popSample(0);
+			float x = wet[channel] * feedbackGain;
+			x = lowCutFilter.processSample(int(channel), x);
+			feedback[channel] = highCutFilter.processSample(int(channel), x);
+		}
+		
+		for (size_t group = 0; group < size_t(numGroups); ++group) {
+			size_t left = size_t(groups[group].left);
+			size_t right = size_t(groups[group].right);
 			
-			float wet = delayLineL.read(delayInSamples);
+			// the host handed over fewer channels than were prepared
+			if (right >= size_t(numChannels)) { continue; }
 			
-			feedbackL = wet * params.feedback;
+			if (right != left) {
+				saturators[group].process(feedback[left], feedback[right]);
+			} else {
+				float unused = 0.f;
+				saturators[group].process(feedback[left], unused);
+			}
+		}
+		
+		if (isCrossfed) {
+			mixCrossfeed();
+		}
+		
+		for (size_t channel = 0; channel < size_t(numChannels); ++channel) {
+			peak = std::max(peak, std::abs(feedback[channel]));
+		}
+		
+		// fade towards the dry signal while bypassed
+		if (params.bypassed) {
+			bypassMix = std::min(1.f, bypassMix + bypassInc);
+		} else {
+			bypassMix = std::max(0.f, bypassMix - bypassInc);
+		}
+		
+		// always 100% dry, 0-100% wet mixing, written with output gain
+		float wetGain = params.mix * duck;
+		
+		for (size_t channel = 0; channel < size_t(numChannels); ++channel) {
+			float out = (dry[channel] + wet[channel] * wetGain) * params.gain;
+			
+			if (bypassMix >= 1.f) {
+				out = dry[channel];
+			} else if (bypassMix > 0.f) {
+				out += (dry[channel] - out) * bypassMix;
+			}
 			
-			float mix = dry + wet * params.mix;
-			outputDataL[sample] = mix * params.gain;
+			outputData[channel][sample] = out;
+		}
+	}
+	
+	feedbackPeak = peak;
+}
+
+void PingPongAudioProcessor::measureOutput(const float* outputDataL, const float* outputDataR,
+										   int numSamples, BlockTelemetry& record) noexcept
+{
+	if (numSamples == 0) { return; }
+	
+	bool isMono = outputDataR == outputDataL;
+	float peakL, peakR;
+	
+	if (truePeakMetering.load(std::memory_order_relaxed)) {
+		peakL = truePeakL.process(outputDataL, numSamples);
+		peakR = isMono ? peakL : truePeakR.process(outputDataR, numSamples);
+	} else {
+		juce::Range<float> rangeL = juce::FloatVectorOperations::findMinAndMax(outputDataL, numSamples);
+		peakL = std::max(-rangeL.getStart(), rangeL.getEnd());
+		
+		if (isMono) {
+			peakR = peakL;
+		} else {
+			juce::Range<float> rangeR = juce::FloatVectorOperations::findMinAndMax(outputDataR, numSamples);
+			peakR = std::max(-rangeR.getStart(), rangeR.getEnd());
 		}
 	}
 	
-	#if JUCE_DEBUG
-	protectYourEars(buffer);
-	#endif
+	levelL.updateIfGreater(peakL);
+	levelR.updateIfGreater(peakR);
+	
+	// RMS level of the block, only published with the telemetry
+	float blockRmsL = std::sqrt(sumOfSquares(outputDataL, numSamples) / float(numSamples));
+	float blockRmsR = isMono ? blockRmsL : std::sqrt(sumOfSquares(outputDataR, numSamples) / float(numSamples));
+	
+	record.peakL = peakL;
+	record.peakR = peakR;
+	record.rmsL = blockRmsL;
+	record.rmsR = blockRmsR;
+}
+
+void PingPongAudioProcessor::setTruePeakMetering(bool shouldUseTruePeak)
+{
+	truePeakMetering.store(shouldUseTruePeak);
+	
+	// remember the meter mode with the plug-in state
+	apvts.state.setProperty("truePeak", shouldUseTruePeak, nullptr);
+}
+
+void PingPongAudioProcessor::switchPreset() noexcept
+{
+	// jump to the new delay time instead of gliding there
+	params.snapDelayTime();
+	
+	// tempo sync already crossfades when the note length changes
+	if (params.tempoSync || delayInSamples == 0.f) { return; }
+	
+	// crossfade between the old and new read position in the same buffers
+	targetDelay = params.delayTime / 1000.f * float(getSampleRate());
+	
+	if (!juce::approximatelyEqual(targetDelay, delayInSamples)) {
+		xfade = xfadeInc;
+	}
+}
+
+void PingPongAudioProcessor::computeModulation() noexcept
+{
+	constexpr int numSamples = parameterUpdateInterval;
+	
+	float targetDepth = params.modDepth * 0.001f * float(getSampleRate());
+	
+	if (targetDepth <= 0.f && modDepthInSamples <= 0.f) {
+		juce::FloatVectorOperations::clear(modL.data(), numSamples);
+		juce::FloatVectorOperations::clear(modR.data(), numSamples);
+		return;
+	}
+	
+	lfo.setRate(params.modRate);
+	lfo.setShape(params.modShape);
+	lfo.setPhaseOffset(params.modPhase);
+	lfo.process(modL.data(), modR.data(), numSamples);
+	
+	// offsets run from 0 to the depth, so modulation only ever lengthens the
+	// delay; the depth is ramped across the cell to avoid zipper noise
+	float depthStep = (targetDepth - modDepthInSamples) / float(numSamples);
+	
+	for (size_t i = 0; i < size_t(numSamples); ++i) {
+		float halfDepth = 0.5f * (modDepthInSamples + depthStep * float(i + 1));
+		modL[i] = halfDepth + halfDepth * modL[i];
+		modR[i] = halfDepth + halfDepth * modR[i];
+	}
+	
+	modDepthInSamples = targetDepth;
 }
 
+float PingPongAudioProcessor::getSyncedTime() const noexcept
+{
+	float syncedTime = float(tempo.getMillisecondsForNoteLength(params.delayNote));
+	if (syncedTime > Parameters::maxDelayTime) {
+		syncedTime = Parameters::maxDelayTime;
+	}
+	
+	return syncedTime;
+}
+
+void PingPongAudioProcessor::updateTailLength() noexcept
+{
+	// nothing the tail depends on has changed
+	if (params.getGeneration() == tailGeneration && juce::exactlyEqual(tempo.getTempo(), tailTempo)) {
+		return;
+	}
+	
+	tailGeneration = params.getGeneration();
+	tailTempo = tempo.getTempo();
+	
+	double delayTime = params.tempoSync ? getSyncedTime() : params.getTargetDelayTime();
+	
+	// peak gain of the high-pass and low-pass in series, found at the geometric
+	// mean of the two cutoffs: k^2 / (1 + k^2) with k = highCut / lowCut
+	double k = double(params.getTargetHighCut()) / double(params.getTargetLowCut());
+	double filterGain = (k * k) / (1.0 + k * k);
+	
+	double loopGain = std::abs(double(params.getTargetFeedback())) * filterGain;
+	
+	// number of echoes until the feedback has decayed by 60 dB
+	double repeats = 1.0;
+	if (loopGain >= 0.999) {
+		repeats = std::numeric_limits<double>::infinity();
+	} else if (loopGain > 0.0) {
+		repeats += std::ceil(std::log(0.001) / std::log(loopGain));
+	}
+	
+	tailSeconds.store(delayTime / 1000.0 * repeats);
+}
+
+#if PINGPONG_DETERMINISTIC
+void PingPongAudioProcessor::updateOutputHash(const juce::AudioBuffer<float>& output) noexcept
+{
+	for (int sample = 0; sample < output.getNumSamples(); ++sample) {
+		for (int channel = 0; channel < output.getNumChannels(); ++channel) {
+			outputHash = hashSamples(output.getReadPointer(channel, sample), 1, outputHash);
+		}
+	}
+}
+#endif
+
 //==============================================================================
 bool PingPongAudioProcessor::hasEditor() const
 {
@@ -371,16 +875,63 @@ juce::AudioProcessorEditor* PingPongAudioProcessor::createEditor()
 }
 
 //==============================================================================
+static void writeSnapshot(juce::OutputStream& stream, const ParameterSnapshot& snapshot)
+{
+	stream.writeFloat(snapshot.gain);
+	stream.writeFloat(snapshot.delayTime);
+	stream.writeFloat(snapshot.mix);
+	stream.writeFloat(snapshot.feedback);
+	stream.writeFloat(snapshot.stereo);
+	stream.writeFloat(snapshot.lowCut);
+	stream.writeFloat(snapshot.highCut);
+}
+
+static void readSnapshot(juce::InputStream& stream, ParameterSnapshot& snapshot)
+{
+	snapshot.gain = stream.readFloat();
+	snapshot.delayTime = stream.readFloat();
+	snapshot.mix = stream.readFloat();
+	snapshot.feedback = stream.readFloat();
+	snapshot.stereo = stream.readFloat();
+	snapshot.lowCut = stream.readFloat();
+	snapshot.highCut = stream.readFloat();
+}
+
 void PingPongAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
     // You should use this method to store your parameters in the memory block.
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
     
-    copyXmlToBinary(*apvts.copyState().createXml(), destData);
+    // copyXmlToBinary(*apvts.copyState().createXml(), destData);
     
-    /** Debug statement for showing xml parameter data **/
-    DBG(apvts.copyState().toXmlString());
+    /** binary state: header, then one id/value pair per parameter **/
+    destData.reset();
+    juce::MemoryOutputStream stream(destData, false);
+    
+    stream.writeInt(stateMagic);
+    stream.writeInt(stateVersion);
+    
+    const juce::Array<juce::AudioProcessorParameter*>& parameters = getParameters();
+    stream.writeInt(parameters.size());
+    
+    for (juce::AudioProcessorParameter* parameter : parameters) {
+		auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+		
+		// plain values, so ranges can change between versions
+		stream.writeString(ranged->getParameterID());
+		stream.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+	}
+	
+	stream.writeBool(isTruePeakMetering());
+	
+	// version 2: A/B morph snapshots
+	const MorphSnapshots& snapshots = params.getSnapshots();
+	stream.writeBool(snapshots.hasA);
+	writeSnapshot(stream, snapshots.a);
+	stream.writeBool(snapshots.hasB);
+	writeSnapshot(stream, snapshots.b);
+	writeSnapshot(stream, snapshots.base);
 }
 
 void PingPongAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
@@ -388,10 +939,60 @@ void PingPongAudioProcessor::setStateInformation (const void* data, int sizeInBy
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
     
+    juce::MemoryInputStream stream(data, size_t(sizeInBytes), false);
+    
+    if (sizeInBytes >= 12 && stream.readInt() == stateMagic) {
+		int version = stream.readInt();
+		int numParameters = stream.readInt();
+		
+		// state from a newer version of the plug-in
+		if (version > stateVersion || numParameters < 0) { return; }
+		
+		const juce::Array<juce::AudioProcessorParameter*>& parameters = getParameters();
+		std::vector<bool> isLoaded(size_t(parameters.size()), false);
+		
+		for (int i = 0; i < numParameters && !stream.isExhausted(); ++i) {
+			juce::String id = stream.readString();
+			float value = stream.readFloat();
+			
+			// parameters that no longer exist are skipped
+			if (juce::RangedAudioParameter* parameter = apvts.getParameter(id)) {
+				parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+				isLoaded[size_t(parameter->getParameterIndex())] = true;
+			}
+		}
+		
+		// parameters added after the state was saved go back to their
+		// defaults, like replaceState() does for XML, instead of keeping
+		// whatever the live session had
+		for (juce::AudioProcessorParameter* parameter : parameters) {
+			if (!isLoaded[size_t(parameter->getParameterIndex())]) {
+				parameter->setValueNotifyingHost(parameter->getDefaultValue());
+			}
+		}
+		
+		setTruePeakMetering(stream.readBool());
+		
+		MorphSnapshots snapshots;
+		if (version >= 2) {
+			snapshots.hasA = stream.readBool();
+			readSnapshot(stream, snapshots.a);
+			snapshots.hasB = stream.readBool();
+			readSnapshot(stream, snapshots.b);
+			readSnapshot(stream, snapshots.base);
+		}
+		params.setSnapshots(snapshots);
+		presetSwitchPending.store(true);
+		return;
+	}
+    
+    /** sessions saved before the binary format stored the APVTS as XML **/
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     
     if (xml.get() != nullptr && xml->hasTagName(apvts.state.getType())) {
 		apvts.replaceState(juce::ValueTree::fromXml(*xml));
+		truePeakMetering.store(bool(apvts.state.getProperty("truePeak", false)));
+		presetSwitchPending.store(true);
 	}
 }
 
@@ -14,6 +14,13 @@
 #include "Tempo.h"
 #include "DelayLine.h"
 #include "Measurement.h"
+#include "TruePeak.h"
+#include "Telemetry.h"
+#include "WaveformSummary.h"
+#include "EditorSettings.h"
+#include "Saturation.h"
+#include "Lfo.h"
+#include "Ducker.h"
 
 //==============================================================================
 /**
@@ -58,28 +65,109 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
     
+    // binary state header, the magic differs from copyXmlToBinary's so old
+    // XML sessions are still recognised
+    static constexpr int stateMagic = 0x50505374; // "PPSt"
+    // version 2 adds the A/B morph snapshots, version 1 blobs still load
+    static constexpr int stateVersion = 2;
+    
     /** Parameters APVTS setup **/
 	juce::AudioProcessorValueTreeState apvts { *this, nullptr, "Parameters", Parameters::createParameterLayout() };
 	Parameters params;
 	
 	Measurement levelL, levelR;
 	
+	// switches the peak meters between sample peak and 4x oversampled true peak
+	void setTruePeakMetering(bool shouldUseTruePeak);
+	bool isTruePeakMetering() const noexcept { return truePeakMetering.load(); }
+	
+	// decimated picture of the delay buffers for the editor
+	WaveformSummary waveform;
+	
+	// per-block records for any UI view or logger, drained by a single reader;
+	// when the ring is full new records are dropped, so a reader that starts
+	// late calls telemetry.skipToNewest() before popping
+	SpscRing<BlockTelemetry, 256> telemetry;
+	
 	juce::AudioProcessorParameter* getBypassParameter() const override;
+	
+   #if PINGPONG_DETERMINISTIC
+	// running hash of everything rendered since prepareToPlay, frame by frame,
+	// so it doesn't depend on how the host split the audio into blocks
+	std::uint64_t getOutputHash() const noexcept { return outputHash; }
+   #endif
 
 private:
+	// starts loading the editor settings as soon as the plug-in exists, so
+	// opening an editor never waits for the file
+	juce::SharedResourcePointer<EditorSettings> editorSettings;
+	
+	void processChannels(const float* const* inputData, float* const* outputData,
+						 int numChannels, const float* keyDataL, const float* keyDataR,
+						 int cellOffset, int numSamples) noexcept;
+	void measureOutput(const float* outputDataL, const float* outputDataR, int numSamples,
+					   BlockTelemetry& record) noexcept;
+	void switchPreset() noexcept;
+	void resetDelayState() noexcept;
+	void computeModulation() noexcept;
+	float getSyncedTime() const noexcept;
+	void updateTailLength() noexcept;
+	
+   #if PINGPONG_DETERMINISTIC
+	void updateOutputHash(const juce::AudioBuffer<float>& output) noexcept;
+   #endif
+	
 	Tempo tempo;
 	
 	// linear is default second template argument
 	// juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine;
 	
-	DelayLine delayLineL, delayLineR;
+	// channels are grouped by speaker position: mirrored left/right channels
+	// ping-pong as a pair, centre and unmatched channels feed back into
+	// themselves, LFE channels stay dry; all of them share one interleaved
+	// delay buffer
+	static constexpr int maxChannels = 16;
+	int preparedChannels = 2;
+	
+	enum ChannelSide { sideLeft = 0, sideRight, sideSingle, sideDry };
+	
+	struct ChannelGroup
+	{
+		int left = 0;
+		int right = 0; // same as left for a single channel
+	};
+	
+	std::array<ChannelGroup, maxChannels> groups {};
+	std::array<int, maxChannels> channelSides {};
+	int numGroups = 0;
+	
+	void updateChannelGroups(const juce::AudioChannelSet& layout) noexcept;
+	
+	// the channels on each side (left members, right members, singles) in
+	// group order; cross-feed only mixes within a side, every channel keeps
+	// 1 - x of its feedback and receives x from the others, so the loop gain
+	// doesn't change and the cost grows linearly with the channel count
+	std::array<std::array<int, maxChannels>, 3> sideMembers {};
+	std::array<int, 3> numSideMembers {};
+	bool hasCrossfeedPartners = false;
+	
+	void mixCrossfeed() noexcept;
+	
+	DelayLine delayLine;
 	
 	// state variable filters
 	juce::dsp::StateVariableTPTFilter<float> lowCutFilter;
 	juce::dsp::StateVariableTPTFilter<float> highCutFilter;
 	
-	float feedbackL = 0.f;
-	float feedbackR = 0.f;
+	// keeps the feedback loop bounded, one per channel group
+	std::array<Saturator, maxChannels> saturators;
+	
+	OutputGuard outputGuard;
+	
+	// turns the wet signal down while the dry input is loud
+	Ducker ducker;
+	
+	std::array<float, maxChannels> feedback {};
 	
 	float lastLowCut = -1.f;
 	float lastHighCut = -1.f;
@@ -90,6 +178,48 @@ private:
 	float xfade = 0.f;
 	float xfadeInc = 0.f;
 	
+	// bypass crossfade, 0 is fully active and 1 fully bypassed; once fully
+	// bypassed without feeding the delay, the DSP is skipped altogether
+	float bypassMix = 0.f;
+	float bypassInc = 0.f;
+	bool bypassSkipping = false;
+	
+	// set by setStateInformation, the next parameter update switches over
+	// by crossfading instead of gliding the delay time
+	std::atomic<bool> presetSwitchPending { false };
+	
+	// parameters are read on a fixed grid of samples, independent of block size
+	static constexpr int parameterUpdateInterval = 32;
+	int samplesUntilUpdate = 0;
+	
+	// read offsets in samples for the current grid cell, filled from the LFO
+	// when the cell starts and indexed by the position within it
+	Lfo lfo;
+	float modDepthInSamples = 0.f;
+	std::array<float, parameterUpdateInterval> modL {};
+	std::array<float, parameterUpdateInterval> modR {};
+	
+	// metering
+	std::atomic<bool> truePeakMetering { false };
+	TruePeakDetector truePeakL, truePeakR;
+	
+	// tail length reported to the host, recomputed when a parameter or the tempo changes
+	std::atomic<double> tailSeconds { 0.0 };
+	juce::uint32 tailGeneration = 0;
+	double tailTempo = 0.0;
+	
+	// silence detection: input and feedback peaks below the threshold for
+	// longer than the delay time means the delay lines hold only silence
+	static constexpr float silenceThreshold = 0.000001f; // -120 dB
+	float feedbackPeak = 0.f;
+	juce::int64 quietSamples = 0;
+	bool idle = false;
+	
+   #if PINGPONG_DETERMINISTIC
+	static constexpr std::uint64_t hashOffsetBasis = 14695981039346656037ull;
+	std::uint64_t outputHash = hashOffsetBasis;
+   #endif
+	
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PingPongAudioProcessor)
 };
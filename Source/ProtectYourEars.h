@@ -12,39 +12,94 @@
 
 #include <JuceHeader.h>
 
-// Silences the buffer if bad or loud values are detected in the output buffer.
-// Use this during debugging to avoid blowing out your eardrums on headphones.
-inline void protectYourEars(juce::AudioBuffer<float>& buffer)
+//==============================================================================
+/**
+    Release-grade output guard. One read-only pass per channel finds both the
+    peak and any NaN/Inf, using an integer max over the sign-stripped bit
+    patterns so the loop vectorizes without fast-math. Overs are caught by a
+    lookahead-free limiter above +6 dBFS: a per-sample peak follower with
+    instant attack and exponential release, so the output never goes over the
+    ceiling and doesn't depend on how the host splits the blocks. It only runs
+    while something is over or the gain is still recovering. A non-finite
+    sample silences only the current block and tells the caller to reset its
+    state.
+*/
+class OutputGuard
 {
-    bool firstWarning = true;
+public:
+    void prepare(double sampleRate) noexcept
+    {
+        releaseCoeff = float(std::exp(-1.0 / (releaseTime * sampleRate)));
+        reset();
+    }
     
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
-        float* channelData = buffer.getWritePointer(channel);
+    void reset() noexcept
+    {
+        gain = 1.f;
+    }
+    
+    // Returns false if the block contained NaN or Inf, in which case it has
+    // been cleared and the processing state should be reset.
+    bool process(juce::AudioBuffer<float>& buffer) noexcept
+    {
+        int numChannels = buffer.getNumChannels();
+        int numSamples = buffer.getNumSamples();
+        juce::uint32 maxBits = 0;
         
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-            float x = channelData[sample];
-            bool silence = false;
+        for (int channel = 0; channel < numChannels; ++channel) {
+            const float* channelData = buffer.getReadPointer(channel);
             
-            if (std::isnan(x)) {
-                DBG("!!! WARNING: nan detected in audio buffer, silencing !!!");
-                silence = true;
-            } else if (std::isinf(x)) {
-                DBG("!!! WARNING: inf detected in audio buffer, silencing !!!");
-                silence = true;
-            } else if (x < -2.0f || x > 2.0f) {  // screaming feedback
-                DBG("!!! WARNING: sample out of range, silencing !!!");
-                silence = true;
-            } else if (x < -1.0f || x > 1.0f) {
-                if (firstWarning) {
-                    DBG("!!! WARNING: sample out of range: " << x << " !!!");
-                    firstWarning = false;
-                }
+            for (int sample = 0; sample < numSamples; ++sample) {
+                juce::uint32 bits;
+                std::memcpy(&bits, channelData + sample, sizeof(bits));
+                maxBits = std::max(maxBits, bits & 0x7fffffffu);
             }
+        }
+        
+        if (maxBits >= 0x7f800000u) {
+            DBG("!!! WARNING: nan or inf detected in audio buffer, resetting !!!");
+            buffer.clear();
+            gain = 1.f;
+            return false;
+        }
+        
+        float peak;
+        std::memcpy(&peak, &maxBits, sizeof(peak));
+        
+        // nothing over and fully released, the follower would leave every
+        // sample as it is
+        if (peak <= ceiling && gain >= 1.f) { return true; }
+        
+        float* const* channels = buffer.getArrayOfWritePointers();
+        
+        for (int sample = 0; sample < numSamples; ++sample) {
+            float framePeak = 0.f;
             
-            if (silence) {
-                buffer.clear();
-                return;
+            for (int channel = 0; channel < numChannels; ++channel) {
+                framePeak = std::max(framePeak, std::abs(channels[channel][sample]));
+            }
+            
+            // instant attack, exponential release towards unity
+            gain = 1.f - (1.f - gain) * releaseCoeff;
+            
+            if (framePeak * gain > ceiling) {
+                gain = ceiling / framePeak;
+            }
+            
+            for (int channel = 0; channel < numChannels; ++channel) {
+                channels[channel][sample] *= gain;
             }
         }
+        
+        return true;
     }
-}
+    
+private:
+    // +6 dBFS, where the old debug check used to mute; floating-point
+    // sessions can carry hot signals that shouldn't be touched
+    static constexpr float ceiling = 2.f;
+    static constexpr double releaseTime = 0.1;
+    
+    float releaseCoeff = 0.f;
+    float gain = 1.f;
+};
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    RefreshHub.cpp
+    Created: 19 Oct 2026 3:02:17pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#include "RefreshHub.h"
+
+static double now()
+{
+	return juce::Time::getMillisecondCounterHiRes() * 0.001;
+}
+
+//==============================================================================
+RefreshHub::RefreshHub()
+{
+}
+
+RefreshHub::~RefreshHub()
+{
+	jassert(subscriptions.empty());
+}
+
+//==============================================================================
+void RefreshHub::subscribe(Client* client, juce::Component* component)
+{
+	JUCE_ASSERT_MESSAGE_THREAD
+	
+	subscriptions.push_back({ client, component });
+	
+	if (vblank == nullptr) {
+		attachToVBlank();
+	}
+	
+	if (!isTimerRunning()) {
+		startTimerHz(fallbackRate);
+	}
+}
+
+void RefreshHub::unsubscribe(Client* client)
+{
+	JUCE_ASSERT_MESSAGE_THREAD
+	
+	std::erase_if(subscriptions, [client](const Subscription& s) { return s.client == client; });
+	
+	// the vblank source may have been the component that just left
+	bool stillAttached = std::any_of(subscriptions.begin(), subscriptions.end(),
+									 [this](const Subscription& s) { return s.component == vblankComponent; });
+	if (!stillAttached) {
+		attachToVBlank();
+	}
+	
+	if (subscriptions.empty()) {
+		stopTimer();
+	}
+}
+
+//==============================================================================
+void RefreshHub::timerCallback()
+{
+	// vblank is driving the frames, nothing to do
+	double time = now();
+	if (time - lastVBlankTime < 0.1) { return; }
+	
+	frame(time);
+}
+
+void RefreshHub::frame(double frameTime)
+{
+	// a client may unsubscribe from inside its callback
+	std::vector<Subscription> current = subscriptions;
+	
+	for (const auto& subscription : current) {
+		subscription.client->refresh(frameTime);
+	}
+}
+
+void RefreshHub::attachToVBlank()
+{
+	vblank.reset();
+	vblankComponent = nullptr;
+	
+	if (subscriptions.empty()) { return; }
+	
+	vblankComponent = subscriptions.front().component;
+	vblank = std::make_unique<juce::VBlankAttachment>(vblankComponent, [this]
+	{
+		lastVBlankTime = now();
+		frame(lastVBlankTime);
+	});
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    RefreshHub.h
+    Created: 19 Oct 2026 3:02:17pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    One frame callback for every animated component in the process. Frames
+    come from a juce::VBlankAttachment on one of the subscribed components,
+    or from a fallback timer while no vblank is arriving (hidden windows,
+    hosts without a peer). Hold it through a juce::SharedResourcePointer.
+*/
+class RefreshHub  : private juce::Timer
+{
+public:
+	class Client
+	{
+	public:
+		virtual ~Client() = default;
+		
+		// called once per frame on the message thread, time in seconds
+		virtual void refresh(double frameTime) = 0;
+	};
+	
+	RefreshHub();
+	~RefreshHub() override;
+	
+	//==============================================================================
+	void subscribe(Client* client, juce::Component* component);
+	void unsubscribe(Client* client);
+
+private:
+	void timerCallback() override;
+	void frame(double frameTime);
+	void attachToVBlank();
+	
+	struct Subscription
+	{
+		Client* client;
+		juce::Component* component;
+	};
+	
+	std::vector<Subscription> subscriptions;
+	
+	std::unique_ptr<juce::VBlankAttachment> vblank;
+	juce::Component* vblankComponent = nullptr;
+	double lastVBlankTime = 0.0;
+	
+	static constexpr int fallbackRate = 60;
+	
+	//==============================================================================
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RefreshHub)
+};
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    Saturation.h
+    Created: 19 Oct 2026 6:20:37pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Polynomial waveshaper for the feedback path with first-order
+    antiderivative anti-aliasing (ADAA). Both shapes have unity gain for small
+    signals and reach exactly +-1 with a flat slope, so feedback can't build
+    up past full scale. Left and right run through the same straight-line
+    code so they can share instructions.
+*/
+class Saturator
+{
+public:
+	enum Mode { off = 0, softClip, tape };
+	
+	//==============================================================================
+	void reset() noexcept
+	{
+		x1 = { 0.f, 0.f };
+		F1 = { antiderivative(0.f), antiderivative(0.f) };
+	}
+	
+	void setMode(int newMode) noexcept
+	{
+		if (newMode == mode) { return; }
+		
+		mode = newMode;
+		
+		// keep the previous antiderivative consistent with the new shape
+		F1 = { antiderivative(x1[0]), antiderivative(x1[1]) };
+	}
+	
+	void process(float& left, float& right) noexcept
+	{
+		if (mode == off) { return; }
+		
+		std::array<float, 2> x = { left, right };
+		std::array<float, 2> F, y;
+		
+		for (size_t ch = 0; ch < 2; ++ch) {
+			F[ch] = antiderivative(x[ch]);
+			float dx = x[ch] - x1[ch];
+			
+			// (F(x) - F(x1)) / (x - x1), or the midpoint when that's ill-conditioned
+			y[ch] = std::abs(dx) > 1e-5f ? (F[ch] - F1[ch]) / dx
+										 : shape(0.5f * (x[ch] + x1[ch]));
+		}
+		
+		x1 = x;
+		F1 = F;
+		left = y[0];
+		right = y[1];
+	}
+	
+private:
+	// input level where the curve reaches full scale; scaling the input by it
+	// gives both curves a slope of 1 at zero, so quiet repeats decay exactly
+	// as they would without saturation
+	float knee() const noexcept
+	{
+		return mode == softClip ? 1.5f : 1.875f;
+	}
+	
+	float shape(float x) const noexcept
+	{
+		float c = juce::jlimit(-1.f, 1.f, x / knee());
+		float c2 = c * c;
+		
+		if (mode == softClip) {
+			// 1.5u - 0.5u^3
+			return c * (1.5f - 0.5f * c2);
+		}
+		
+		// 15/8 (u - 2/3 u^3 + 1/5 u^5), a softer knee
+		return 1.875f * c * (1.f + c2 * (-0.6666667f + 0.2f * c2));
+	}
+	
+	// k * G(x / k), where G is the antiderivative of the unscaled curve
+	float antiderivative(float x) const noexcept
+	{
+		float k = knee();
+		float u = x / k;
+		float a = std::abs(u);
+		float u2 = u * u;
+		
+		if (mode == softClip) {
+			if (a > 1.f) { return std::abs(x) - 0.375f * k; }
+			return k * u2 * (0.75f - 0.125f * u2);
+		}
+		
+		if (a > 1.f) { return std::abs(x) - 0.3125f * k; }
+		return k * 1.875f * u2 * (0.5f + u2 * (-0.16666667f + 0.033333333f * u2));
+	}
+	
+	int mode = off;
+	std::array<float, 2> x1 {};
+	std::array<float, 2> F1 {};
+};
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    Telemetry.h
+    Created: 19 Oct 2026 11:40:05am
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Wait-free single-producer/single-consumer ring buffer. The audio thread
+    pushes, one UI component or logger pops. Pushing into a full ring drops
+    the new item instead of blocking, so a ring nobody drained for a while
+    holds old items; a reader that only wants recent ones skips the rest
+    with skipToNewest() first.
+*/
+template<typename T, size_t capacity>
+class SpscRing
+{
+public:
+	static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+	static_assert(std::is_trivially_copyable_v<T>, "items are copied by value");
+	
+	bool push(const T& item) noexcept
+	{
+		const size_t write = writeIndex.load(std::memory_order_relaxed);
+		const size_t read = readIndex.load(std::memory_order_acquire);
+		
+		if (write - read == capacity) { return false; }
+		
+		items[write & mask] = item;
+		writeIndex.store(write + 1, std::memory_order_release);
+		return true;
+	}
+	
+	bool pop(T& item) noexcept
+	{
+		const size_t read = readIndex.load(std::memory_order_relaxed);
+		const size_t write = writeIndex.load(std::memory_order_acquire);
+		
+		if (read == write) { return false; }
+		
+		item = items[read & mask];
+		readIndex.store(read + 1, std::memory_order_release);
+		return true;
+	}
+	
+	// consumer side: discards everything except the newest numToKeep items,
+	// returns how many were discarded
+	size_t skipToNewest(size_t numToKeep) noexcept
+	{
+		const size_t read = readIndex.load(std::memory_order_relaxed);
+		const size_t write = writeIndex.load(std::memory_order_acquire);
+		
+		if (write - read <= numToKeep) { return 0; }
+		
+		readIndex.store(write - numToKeep, std::memory_order_release);
+		return write - numToKeep - read;
+	}
+	
+	size_t getNumReady() const noexcept
+	{
+		return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+	}
+	
+private:
+	static constexpr size_t mask = capacity - 1;
+	
+	// keep the two indices on separate cache lines
+	alignas(64) std::atomic<size_t> writeIndex { 0 };
+	alignas(64) std::atomic<size_t> readIndex { 0 };
+	std::array<T, capacity> items {};
+};
+
+//==============================================================================
+/**
+    One record per processed block, published by the audio thread.
+*/
+struct BlockTelemetry
+{
+	float peakL = 0.f;
+	float peakR = 0.f;
+	float rmsL = 0.f;
+	float rmsR = 0.f;
+	float delayInSamples = 0.f;
+	float crossfade = 0.f;
+	double processingTime = 0.0; // seconds
+	int numSamples = 0;
+	bool idle = false;
+};
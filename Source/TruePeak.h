@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    TruePeak.h
+    Created: 19 Oct 2026 10:12:40am
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Estimates the inter-sample peak of a signal by upsampling it 4x with a
+    polyphase windowed-sinc interpolator, in the spirit of ITU-R BS.1770.
+*/
+class TruePeakDetector
+{
+public:
+	TruePeakDetector()
+	{
+		// 48-tap Hann-windowed sinc prototype, split into four phases
+		const double centre = (numTaps - 1) / 2.0;
+		
+		for (int n = 0; n < numTaps; ++n) {
+			double x = (n - centre) / double(oversampling);
+			double sinc = juce::approximatelyEqual(x, 0.0) ? 1.0
+								: std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+			double window = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * (n + 1) / (numTaps + 1));
+			
+			coefficients[size_t(n % oversampling)][size_t(n / oversampling)] = float(sinc * window);
+		}
+	}
+	
+	//==============================================================================
+	void reset() noexcept
+	{
+		history.fill(0.f);
+		position = 0;
+	}
+	
+	// returns the highest absolute value of the upsampled block
+	float process(const float* data, int numSamples) noexcept
+	{
+		float peak = 0.f;
+		
+		for (int sample = 0; sample < numSamples; ++sample) {
+			// history is stored twice so the taps can be read without wrapping
+			position = (position == 0 ? tapsPerPhase : position) - 1;
+			history[size_t(position)] = data[sample];
+			history[size_t(position + tapsPerPhase)] = data[sample];
+			
+			const float* x = history.data() + position;
+			
+			for (const auto& phase : coefficients) {
+				float y = 0.f;
+				
+				for (int k = 0; k < tapsPerPhase; ++k) {
+					y += phase[size_t(k)] * x[k];
+				}
+				
+				peak = std::max(peak, std::abs(y));
+			}
+		}
+		
+		return peak;
+	}
+	
+private:
+	static constexpr int oversampling = 4;
+	static constexpr int tapsPerPhase = 12;
+	static constexpr int numTaps = oversampling * tapsPerPhase;
+	
+	std::array<std::array<float, tapsPerPhase>, oversampling> coefficients {};
+	std::array<float, tapsPerPhase * 2> history {};
+	int position = 0;
+	
+	//==============================================================================
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TruePeakDetector)
+};
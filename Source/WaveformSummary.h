@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    WaveformSummary.h
+    Created: 19 Oct 2026 1:05:22pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayLine.h"
+
+//==============================================================================
+/**
+    Decimated min/max picture of the delay buffers. The audio thread folds
+    each block into fixed-size columns and publishes finished columns into
+    one of two snapshot slots, the editor copies out the latest slot.
+*/
+class WaveformSummary
+{
+public:
+	static constexpr int numColumns = 256;
+	
+	struct Snapshot
+	{
+		std::array<float, numColumns> minL {}, maxL {}, minR {}, maxR {};
+		int head = 0; // index of the oldest column
+	};
+	
+	//==============================================================================
+	void prepare(int bufferLength) noexcept
+	{
+		samplesPerColumn = std::max(1, bufferLength / numColumns);
+		
+		working = Snapshot();
+		accumulated = 0;
+		numAudibleColumns = 0;
+		isSilencePublished = false;
+		
+		if (publish()) {
+			isSilencePublished = true;
+		}
+	}
+	
+	// audio thread: fold in the samples written to the delay line during this
+	// block, a long block can finish several columns and a partly filled
+	// column carries over to the next block
+	void push(const DelayLine& delayLine, int numSamples) noexcept
+	{
+		int channelR = delayLine.getNumChannels() > 1 ? 1 : 0;
+		int remaining = std::min(numSamples, delayLine.getBufferLength() - 1);
+		bool isColumnFinished = false;
+		
+		while (remaining > 0) {
+			int count = std::min(remaining, samplesPerColumn - accumulated);
+			
+			// oldest samples first, these end (remaining - count) samples ago
+			int samplesAgo = remaining - count;
+			juce::Range<float> rangeL = delayLine.getRecentRange(0, count, samplesAgo);
+			juce::Range<float> rangeR = delayLine.getRecentRange(channelR, count, samplesAgo);
+			
+			if (accumulated == 0) {
+				columnL = rangeL;
+				columnR = rangeR;
+			} else {
+				columnL = columnL.getUnionWith(rangeL);
+				columnR = columnR.getUnionWith(rangeR);
+			}
+			
+			accumulated += count;
+			remaining -= count;
+			
+			if (accumulated == samplesPerColumn) {
+				size_t column = size_t(working.head);
+				numAudibleColumns += (isSilent(columnL, columnR) ? 0 : 1) - (isSilent(column) ? 0 : 1);
+				
+				working.minL[column] = columnL.getStart();
+				working.maxL[column] = columnL.getEnd();
+				working.minR[column] = columnR.getStart();
+				working.maxR[column] = columnR.getEnd();
+				working.head = (working.head + 1) % numColumns;
+				
+				accumulated = 0;
+				isColumnFinished = true;
+			}
+		}
+		
+		// an all-silent picture only needs publishing once, scrolling it
+		// wouldn't change anything while idle or bypassed
+		if (!isColumnFinished || (numAudibleColumns == 0 && isSilencePublished)) { return; }
+		
+		if (publish()) {
+			isSilencePublished = numAudibleColumns == 0;
+		}
+	}
+	
+	// message thread: copy out the most recently published snapshot
+	void read(Snapshot& destination) noexcept
+	{
+		int index;
+		
+		// claim the slot, then make sure it's still the published one
+		do {
+			index = published.load();
+			reading.store(index);
+		} while (published.load() != index);
+		
+		destination = slots[size_t(index)];
+		reading.store(-1);
+	}
+	
+	// bumped on every publish, the editor only repaints when it has moved
+	juce::uint32 getPublishCount() const noexcept { return publishCount.load(); }
+	
+private:
+	bool publish() noexcept
+	{
+		int target = 1 - published.load();
+		
+		// the editor is still copying this slot, try again on the next column
+		if (reading.load() == target) { return false; }
+		
+		slots[size_t(target)] = working;
+		published.store(target);
+		publishCount.fetch_add(1);
+		return true;
+	}
+	
+	static bool isSilent(juce::Range<float> rangeL, juce::Range<float> rangeR) noexcept
+	{
+		return juce::exactlyEqual(rangeL.getStart(), 0.f) && juce::exactlyEqual(rangeL.getEnd(), 0.f)
+			&& juce::exactlyEqual(rangeR.getStart(), 0.f) && juce::exactlyEqual(rangeR.getEnd(), 0.f);
+	}
+	
+	bool isSilent(size_t column) const noexcept
+	{
+		return isSilent({ working.minL[column], working.maxL[column] },
+						{ working.minR[column], working.maxR[column] });
+	}
+	
+	int samplesPerColumn = 1;
+	int accumulated = 0;
+	juce::Range<float> columnL, columnR;
+	Snapshot working;
+	
+	// columns in working that aren't exactly zero
+	int numAudibleColumns = 0;
+	bool isSilencePublished = false;
+	
+	std::array<Snapshot, 2> slots;
+	std::atomic<int> published { 0 };
+	std::atomic<int> reading { -1 };
+	std::atomic<juce::uint32> publishCount { 0 };
+};
@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 20 Oct 2026 10:04:18am
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Runs every PingPong unit test and returns non-zero if any of them failed.
+int main(int, char**)
+{
+	// the processor owns timers and shared settings, which need the message manager
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+	
+	juce::UnitTestRunner runner;
+	runner.setAssertOnFailure(false);
+	runner.runTestsInCategory("PingPong");
+	
+	int failures = 0;
+	for (int i = 0; i < runner.getNumResults(); ++i) {
+		failures += runner.getResult(i)->failures;
+	}
+	
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    RegressionTests.cpp
+    Created: 20 Oct 2026 10:11:52am
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "TestHelpers.h"
+
+#if ! PINGPONG_DETERMINISTIC
+ #error "the regression tests need a PINGPONG_DETERMINISTIC=1 build"
+#endif
+
+//==============================================================================
+/**
+    Renders a fixed input and parameter script through processBlock and
+    compares the output hash across block sizes and against a golden value.
+
+    The block sizes include ones that don't divide the 32-sample parameter
+    grid, so host blocks split grid cells. The automation is delivered the
+    way a host with sample-accurate automation does, by splitting the block
+    at the automation point.
+
+    The golden hash belongs to the reference build (this project, x86-64,
+    -ffp-contract=off) and lives in GoldenHash.txt next to this file. Other
+    platforms may round the libm calls in the filters differently, the block
+    size check holds everywhere. Without the file the render is recorded into
+    it and the run says so; commit it from the reference build. When a change
+    to the DSP is intended, delete the file and record it again.
+*/
+class RegressionTest : public juce::UnitTest
+{
+public:
+	RegressionTest() : juce::UnitTest("Deterministic render", "PingPong") {}
+	
+	void runTest() override
+	{
+		beginTest("Output hash doesn't depend on the block size");
+		
+		std::uint64_t reference = render({ 512 });
+		
+		for (const std::vector<int>& blockSizes : std::vector<std::vector<int>> {
+				{ 1 }, { 32 }, { 64 }, { 100 }, { 441 }, { 1000 }, { 1024 }, { 4096 },
+				{ 96, 160, 32, 224 }, { 7, 1000, 33, 441, 1 } }) {
+			std::uint64_t hash = render(blockSizes);
+			expect(hash == reference, "block sizes starting with " + juce::String(blockSizes.front())
+								   + " rendered " + toHex(hash) + ", 512 rendered " + toHex(reference));
+		}
+		
+		beginTest("Output hash matches the golden render");
+		
+		juce::File goldenFile = getGoldenFile();
+		
+		if (!goldenFile.existsAsFile()) {
+			expect(goldenFile.replaceWithText(toHex(reference) + "\n"), "couldn't write " + goldenFile.getFullPathName());
+			logMessage("no golden hash yet, recorded " + toHex(reference) + " in " + goldenFile.getFullPathName());
+			return;
+		}
+		
+		juce::String golden = goldenFile.loadFileAsString().trim();
+		expect(golden == toHex(reference), "expected " + golden + ", rendered " + toHex(reference));
+	}
+	
+	static constexpr double sampleRate = 48000.0;
+	static constexpr int numSamples = 98304;
+	
+	// on a grid boundary, every render splits its block here
+	static constexpr int automationSample = 49152;
+	
+	// the source directory, the build may compile this file by a relative path
+	static juce::File getGoldenFile()
+	{
+		return juce::File::getCurrentWorkingDirectory().getChildFile(__FILE__).getSiblingFile("GoldenHash.txt");
+	}
+	
+	static juce::String toHex(std::uint64_t hash)
+	{
+		return "0x" + juce::String::toHexString(juce::int64(hash)).paddedLeft('0', 16);
+	}
+	
+	// noise bursts from a fixed seed, with silent gaps in between
+	static void fillInput(juce::AudioBuffer<float>& input)
+	{
+		juce::Random random(0x50494e47);
+		
+		for (int sample = 0; sample < input.getNumSamples(); ++sample) {
+			bool isBurst = (sample % 24000) < 2400;
+			float left = random.nextFloat() - 0.5f;
+			float right = random.nextFloat() - 0.5f;
+			
+			input.setSample(0, sample, isBurst ? left : 0.f);
+			input.setSample(1, sample, isBurst ? right : 0.f);
+		}
+	}
+	
+	static std::uint64_t render(const std::vector<int>& blockSizes)
+	{
+		PingPongAudioProcessor processor;
+		
+		setParameter(processor, delayTimeParamID, 180.f);
+		setParameter(processor, feedbackParamID, 70.f);
+		setParameter(processor, mixParamID, 60.f);
+		setParameter(processor, stereoParamID, 50.f);
+		setParameter(processor, lowCutParamID, 150.f);
+		setParameter(processor, highCutParamID, 9000.f);
+		setParameter(processor, saturationParamID, 2.f);
+		setParameter(processor, modDepthParamID, 2.f);
+		setParameter(processor, modRateParamID, 1.5f);
+		setParameter(processor, duckAmountParamID, 50.f);
+		
+		int maxBlockSize = *std::max_element(blockSizes.begin(), blockSizes.end());
+		processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+		processor.prepareToPlay(sampleRate, maxBlockSize);
+		
+		juce::AudioBuffer<float> audio(2, numSamples);
+		fillInput(audio);
+		
+		juce::MidiBuffer midi;
+		int position = 0;
+		
+		for (size_t block = 0; position < numSamples; ++block) {
+			if (position == automationSample) {
+				setParameter(processor, tempoSyncParamID, 1.f);
+				setParameter(processor, feedbackParamID, 40.f);
+				setParameter(processor, modShapeParamID, 2.f);
+			}
+			
+			int count = std::min(blockSizes[block % blockSizes.size()], numSamples - position);
+			
+			if (position < automationSample && position + count > automationSample) {
+				count = automationSample - position;
+			}
+			
+			juce::AudioBuffer<float> view(audio.getArrayOfWritePointers(), 2, position, count);
+			processor.processBlock(view, midi);
+			position += count;
+		}
+		
+		processor.releaseResources();
+		return processor.getOutputHash();
+	}
+};
+
+static RegressionTest regressionTest;
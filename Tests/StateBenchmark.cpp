@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+    StateBenchmark.cpp
+    Created: 20 Oct 2026 2:37:05pm
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "TestHelpers.h"
+
+//==============================================================================
+/**
+    Checks that the binary state round-trips, that parameters missing from a
+    blob get their defaults and that old XML sessions still load, then logs
+    the average cost of one save and one load call. The timings are only
+    reported, a busy machine shouldn't fail the run.
+*/
+class StateBenchmark : public juce::UnitTest
+{
+public:
+	StateBenchmark() : juce::UnitTest("State save/load", "PingPong") {}
+	
+	void runTest() override
+	{
+		PingPongAudioProcessor processor;
+		setParameter(processor, delayTimeParamID, 320.f);
+		setParameter(processor, feedbackParamID, 30.f);
+		setParameter(processor, saturationParamID, 1.f);
+		processor.params.captureSnapshot(0);
+		setParameter(processor, feedbackParamID, 55.f);
+		processor.params.captureSnapshot(1);
+		
+		juce::MemoryBlock binary;
+		processor.getStateInformation(binary);
+		
+		// the blob sessions were saved as before the binary format
+		juce::MemoryBlock xml;
+		juce::AudioProcessor::copyXmlToBinary(*processor.apvts.copyState().createXml(), xml);
+		
+		beginTest("Binary state round-trips");
+		{
+			PingPongAudioProcessor restored;
+			restored.setStateInformation(binary.getData(), int(binary.getSize()));
+			expectParameters(restored);
+			
+			const MorphSnapshots& snapshots = restored.params.getSnapshots();
+			expect(snapshots.hasA && snapshots.hasB);
+			expectEquals(snapshots.a.feedback, 30.f);
+			expectEquals(snapshots.b.feedback, 55.f);
+			expectEquals(snapshots.base.feedback, 55.f);
+		}
+		
+		beginTest("Version 1 state still loads");
+		{
+			// parameters and the meter mode, no morph snapshots yet
+			juce::MemoryBlock version1;
+			{
+				juce::MemoryOutputStream stream(version1, false);
+				stream.writeInt(PingPongAudioProcessor::stateMagic);
+				stream.writeInt(1);
+				
+				const juce::Array<juce::AudioProcessorParameter*>& parameters = processor.getParameters();
+				stream.writeInt(parameters.size());
+				
+				for (juce::AudioProcessorParameter* parameter : parameters) {
+					auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+					stream.writeString(ranged->getParameterID());
+					stream.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+				}
+				
+				stream.writeBool(true);
+			}
+			
+			// snapshots from before the load don't survive it
+			PingPongAudioProcessor restored;
+			restored.params.captureSnapshot(0);
+			restored.params.captureSnapshot(1);
+			restored.setStateInformation(version1.getData(), int(version1.getSize()));
+			
+			expectParameters(restored);
+			expect(restored.isTruePeakMetering());
+			expect(!restored.params.getSnapshots().hasA && !restored.params.getSnapshots().hasB);
+		}
+		
+		beginTest("Parameters missing from the state get their defaults");
+		{
+			// a blob saved before Saturation existed
+			juce::MemoryBlock old;
+			{
+				juce::MemoryOutputStream stream(old, false);
+				stream.writeInt(PingPongAudioProcessor::stateMagic);
+				stream.writeInt(1);
+				stream.writeInt(1);
+				stream.writeString(delayTimeParamID.getParamID());
+				stream.writeFloat(320.f);
+				stream.writeBool(false);
+			}
+			
+			PingPongAudioProcessor restored;
+			setParameter(restored, saturationParamID, 2.f);
+			setParameter(restored, modDepthParamID, 5.f);
+			restored.setStateInformation(old.getData(), int(old.getSize()));
+			
+			expectWithinAbsoluteError(getParameter(restored, delayTimeParamID), 320.f, 0.01f);
+			expectEquals(getParameter(restored, saturationParamID), 0.f);
+			expectEquals(getParameter(restored, modDepthParamID), 0.f);
+		}
+		
+		beginTest("XML state still loads");
+		{
+			PingPongAudioProcessor restored;
+			restored.setStateInformation(xml.getData(), int(xml.getSize()));
+			expectParameters(restored);
+		}
+		
+		beginTest("Save and load cost per call");
+		
+		double saveTime = timePerCall([&] {
+			juce::MemoryBlock block;
+			processor.getStateInformation(block);
+		});
+		
+		double binaryLoadTime = timePerCall([&] {
+			processor.setStateInformation(binary.getData(), int(binary.getSize()));
+		});
+		
+		double xmlLoadTime = timePerCall([&] {
+			processor.setStateInformation(xml.getData(), int(xml.getSize()));
+		});
+		
+		logMessage("state size: " + juce::String(binary.getSize()) + " bytes binary, "
+				   + juce::String(xml.getSize()) + " bytes XML");
+		logMessage("save: " + toMicroseconds(saveTime));
+		logMessage("load binary: " + toMicroseconds(binaryLoadTime));
+		logMessage("load XML: " + toMicroseconds(xmlLoadTime));
+		
+		expect(binary.getSize() < xml.getSize(), "the binary state should be smaller than the XML");
+	}
+	
+	static constexpr int numCalls = 2000;
+	
+	void expectParameters(PingPongAudioProcessor& processor)
+	{
+		expectWithinAbsoluteError(getParameter(processor, delayTimeParamID), 320.f, 0.01f);
+		expectWithinAbsoluteError(getParameter(processor, feedbackParamID), 55.f, 0.01f);
+		expectWithinAbsoluteError(getParameter(processor, saturationParamID), 1.f, 0.01f);
+	}
+	
+	// average seconds per call, after a few calls to warm up the caches
+	template <typename Function>
+	static double timePerCall(Function&& function)
+	{
+		for (int i = 0; i < 10; ++i) {
+			function();
+		}
+		
+		juce::int64 start = juce::Time::getHighResolutionTicks();
+		
+		for (int i = 0; i < numCalls; ++i) {
+			function();
+		}
+		
+		juce::int64 ticks = juce::Time::getHighResolutionTicks() - start;
+		return juce::Time::highResolutionTicksToSeconds(ticks) / numCalls;
+	}
+	
+	static juce::String toMicroseconds(double seconds)
+	{
+		return juce::String(seconds * 1.0e6, 2) + " us per call";
+	}
+};
+
+static StateBenchmark stateBenchmark;
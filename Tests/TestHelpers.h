@@ -0,0 +1,28 @@
+/*
+  ==============================================================================
+
+    TestHelpers.h
+    Created: 21 Oct 2026 9:12:40am
+    Author:  Ethan Miller
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+//==============================================================================
+// sets a parameter by its plain value, the way a host or the editor would
+inline void setParameter(PingPongAudioProcessor& processor, const juce::ParameterID& id, float value)
+{
+	juce::RangedAudioParameter* parameter = processor.apvts.getParameter(id.getParamID());
+	parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+inline float getParameter(PingPongAudioProcessor& processor, const juce::ParameterID& id)
+{
+	juce::RangedAudioParameter* parameter = processor.apvts.getParameter(id.getParamID());
+	return parameter->convertFrom0to1(parameter->getValue());
+}